@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace chip8::aot
+{
+    // Translates a ROM into a C++ translation unit defining chip8_compiled_rom (see cpu/CompiledRom.hpp).
+    //
+    // Blocks are discovered by following jumps, calls and skips from the program start. Register arithmetic, constant loads into V and I,
+    // jumps and skips are translated. Everything else is left to the interpreter: other instructions, code only reachable through computed
+    // jumps (Bnnn) or returns, and blocks overwritten at run time.
+    class RomTranslator
+    {
+      public:
+        explicit RomTranslator(const std::vector<uint8_t>& rom);
+
+        std::string translate(const std::string& romName) const;
+
+        // Start addresses and lengths (in instructions) of the translated blocks.
+        const std::map<uint16_t, size_t>& getBlocks() const;
+
+      private:
+        bool isInRom(const size_t address) const;
+        bool isTranslatable(const uint16_t address) const;
+        std::vector<uint16_t> getSuccessors(const uint16_t address) const;
+        std::set<uint16_t> findReachableAddresses() const;
+        void findBlocks();
+
+        std::string translateBlock(const uint16_t start, const size_t length) const;
+        std::string translateInstruction(const uint16_t address) const;
+        std::string translateExit(const uint16_t target) const;
+
+      private:
+        static constexpr uint16_t ProgramStartLocation = 0x200;
+        static constexpr size_t MemorySize = 4 * 1024;
+
+        const std::vector<uint8_t> rom;
+        std::map<uint16_t, size_t> blocks;
+    };
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <vector>
+
+namespace chip8::batch
+{
+    struct BatchJob
+    {
+        std::filesystem::path rom;
+        uint64_t seed;
+        std::filesystem::path inputScript; // Empty for no input (see chip8::InputScript)
+        uint64_t instructions;
+    };
+
+    // Reads one job per line, as "<rom> <seed> <input script> <instructions>", "-" standing for no input script: "PONG 1 pong.keys 1000000".
+    // Relative paths are relative to directory, usually the one of the manifest. Empty lines and lines starting with # are ignored.
+    // Throws ManifestException if a line is malformed, or if its number of instructions is 0.
+    std::vector<chip8::batch::BatchJob> readManifest(std::istream& manifest, const std::filesystem::path& directory);
+}
\ No newline at end of file
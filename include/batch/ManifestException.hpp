@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace chip8::batch
+{
+    class ManifestException : public std::runtime_error
+    {
+      public:
+        explicit ManifestException(const std::string& message)
+            : std::runtime_error("Error reading manifest: " + message)
+        {
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace chip8::batch
+{
+    // Runs a known number of independent jobs on a fixed number of threads.
+    //
+    // Each worker starts with a contiguous range of jobs, which it runs from the front. A worker that runs out of jobs steals the back half
+    // of the largest range left, so that threads stay busy however unequal the jobs are, while workers mostly run neighboring jobs.
+    class WorkStealingPool
+    {
+      public:
+        // 0 for one thread per hardware thread.
+        explicit WorkStealingPool(const size_t threads = 0);
+
+        size_t getThreadCount() const;
+
+        // Calls task(job, worker) for every job in [0, jobs), worker being in [0, getThreadCount()), and returns once all of them are done.
+        // Jobs of a worker are run one after the other on the same thread, so that tasks can reuse per-worker state. If tasks throw, the
+        // remaining jobs are skipped and the first exception is rethrown.
+        void run(const size_t jobs, const std::function<void(size_t job, size_t worker)>& task);
+
+      private:
+        // Jobs [begin, end) left to a worker, packed into one word so that its owner and thieves can update it with a single CAS.
+        struct alignas(64) Range
+        {
+            std::atomic<uint64_t> jobs;
+        };
+
+        static uint64_t pack(const uint32_t begin, const uint32_t end);
+        bool takeJob(const size_t worker, uint32_t& job);
+        bool steal(const size_t worker);
+        void work(const size_t worker, const std::function<void(size_t job, size_t worker)>& task);
+
+        const size_t threads;
+        std::vector<Range> ranges;
+        std::atomic<bool> failed;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8
+{
+    // ROM translated into C++ ahead of time by chip8-aot (see Cpu::setCompiledRom). The generated translation unit defines an instance of
+    // this structure named chip8_compiled_rom.
+    struct CompiledRom
+    {
+        // Guest state read and written by the generated code.
+        struct State
+        {
+            std::array<uint8_t, 16> V;
+            uint16_t I;
+            uint16_t PC;
+            int64_t budget;          // Number of instructions left to execute
+            const uint8_t* modified; // Non-zero for the addresses where a block may have been overwritten since boot
+            uint8_t delayTimer;      // Value of the delay timer when the code was entered, read by Fx07
+        };
+
+        // Translated blocks are at most MaxBlockLength instructions long, so that overwriting memory invalidates a bounded range of blocks.
+        static constexpr size_t MaxBlockLength = 32;
+
+        // ROM the code was translated from: the code is only used if the booted ROM is the same.
+        const uint8_t* image;
+        size_t imageSize;
+
+        // Runs translated blocks from state.PC until the budget is too small for the next block or the next instruction is not the start
+        // of a translated block. Only whole blocks are executed: state.budget is decremented by the length of each of them.
+        void (*run)(State& state);
+    };
+}
+
+// Defined by the translation units generated by chip8-aot.
+extern "C" const chip8::CompiledRom chip8_compiled_rom;
@@ -4,24 +4,54 @@
 #include <istream>
 #include <logging/Logger.hpp>
 #include <memory>
-#include <random>
+#include <span>
 
+#include "CompiledRom.hpp"
+#include "CpuSnapshot.hpp"
 #include "CpuState.hpp"
+#include "DisplayMode.hpp"
+#include "ExecutionEngine.hpp"
 #include "IGpu.hpp"
 #include "ITimer.hpp"
 #include "InstructionSet.hpp"
 #include "Key.hpp"
+#include "RandomGenerator.hpp"
 #include "Registers.hpp"
+#include "RunResult.hpp"
 
 namespace chip8
 {
-    class Cpu
+    class JitCompiler;
+
+    // CPU calling its peripherals through GpuType and TimerType: with concrete (final) types rather than interfaces, their calls are direct
+    // and can be inlined. BoundsPolicy checks the addresses of memory and stack accesses (see chip8::CheckedBounds and
+    // chip8::WrappedBounds). The instantiations are defined in Cpu.cpp: the interfaces, and chip8::Gpu with chip8::FrameTimer or
+    // chip8::Timer.
+    template <typename GpuType, typename TimerType, typename BoundsPolicy = chip8::DefaultBoundsPolicy>
+    class BasicCpu
     {
       public:
-        Cpu(const logging::Logger& logger, chip8::IGpu& gpu, chip8::ITimer& soundTimer, chip8::ITimer& delayTimer);
+        using Registers = chip8::BasicRegisters<BoundsPolicy>;
+
+        BasicCpu(const logging::Logger& logger,
+                 GpuType& gpu,
+                 TimerType& soundTimer,
+                 TimerType& delayTimer,
+                 const chip8::ExecutionEngine engine = chip8::ExecutionEngine::Interpreter,
+                 chip8::RandomGenerator randomGenerator = chip8::RandomGenerator());
+        ~BasicCpu();
 
+        // Runs the given ROM translated ahead of time instead of interpreting it wherever possible, from the next boot on, provided the
+        // booted ROM is the one it was translated from. nullptr disables it.
+        void setCompiledRom(const chip8::CompiledRom* compiledRom);
+        void setDisplayMode(const chip8::DisplayMode displayMode);
+        // Replaces the random number generator, e.g. to run the next ROM of a batch with another seed.
+        void setRandomGenerator(chip8::RandomGenerator randomGenerator);
         void boot(std::istream& stream);
         void runClockCycle();
+        // Executes at most maxInstructions instructions, stopping early if the CPU waits for a key press, or for the next frame after a draw
+        // in DisplayMode::DisplayWait. Front-ends are expected to call it once per frame and to redraw if the result says the frame is dirty.
+        chip8::RunResult run(const size_t maxInstructions);
         void onKeyPressed(const chip8::Key key);
         void onKeyReleased(const chip8::Key key);
         bool shouldPlayAudio() const;
@@ -30,45 +60,85 @@ namespace chip8
 
         size_t getWidth() const;
         size_t getHeight() const;
-        const std::vector<bool>& getFrameBuffer() const;
+        std::span<const uint64_t> getFrameBuffer() const;
+        uint32_t getDirtyRows() const;
 
-        chip8::Registers& getRegisters();
+        Registers& getRegisters();
+
+        // Copies the whole machine state, framebuffer and timers included. Throws std::logic_error with the standard random engine (see
+        // RandomGenerator::getState).
+        chip8::CpuSnapshot save() const;
+        // Replaces the whole machine state. Only the decoded instructions and native code of the bytes of memory that change are discarded,
+        // as if the program had written them, so that restoring snapshots of the running program keeps most of them. Throws
+        // std::invalid_argument if I, PC or SP are out of bounds or the state is unknown, and std::logic_error if the random generator cannot
+        // be restored, leaving the machine unchanged.
+        void restore(const chip8::CpuSnapshot& snapshot);
 
       private:
-        static constexpr size_t MemorySize = 4 * 1204; // 4KB
-        static constexpr size_t StackSize = 64;
+        static constexpr size_t MemorySize = Registers::MemorySize;
+        static constexpr size_t StackSize = Registers::StackSize;
         static constexpr size_t ProgramStartLocation = 0x200;
         static constexpr size_t VF = 0xf;
+        static constexpr size_t MaxBasicBlockLength = 32;
+
+        using InstructionSet = chip8::BasicInstructionSet<BasicCpu>;
+        using DecodedInstruction = typename InstructionSet::DecodedInstruction;
 
         const logging::Logger& logger;
-        chip8::InstructionSet instructions;
+        GpuType& gpu;
+        TimerType& soundTimer;
+        TimerType& delayTimer;
 
         // ==================== CPU compontents ====================
-        chip8::Registers registers;
+        // Instruction decoding tables are shared by all the instances (see BasicInstructionSet::getInstance), so that the per-instance state is
+        // only the machine state below, laid out contiguously.
+        Registers registers;
         std::array<uint8_t, MemorySize> memory;
         std::array<uint8_t, StackSize> stack;
-        chip8::IGpu& gpu;
-        chip8::ITimer& soundTimer;
-        chip8::ITimer& delayTimer;
         std::array<bool, 16> keyPressedStatus;
-        std::random_device randomDevice;
-        std::default_random_engine randomEngine;
-        // random generator for uint8_t. Note: it cannot be uniform_int_distribution<uint8_t> because the effect is undefined for that
-        // type (see C++ specifications).
-        std::uniform_int_distribution<unsigned long> uniformDistrubution;
+        chip8::RandomGenerator randomGenerator;
         bool playAudioFlag;
+        bool frameDirty; // Since the beginning of the current run
         chip8::CpuState state;
+        chip8::DisplayMode displayMode;
+
+        // ==================== Execution engine ====================
+        chip8::ExecutionEngine engine;
+        // Instructions decoded by all the engines but Interpreter, indexed by address. Entries without callback have not been decoded yet.
+        // The Threaded engine replaces the index of the instructions starting a superinstruction (see findSuperinstruction).
+        std::vector<DecodedInstruction> decodedInstructions;
+        // Number of instructions of the basic block starting at each address, or 0 if not discovered yet (BasicBlock engine only).
+        std::vector<uint8_t> basicBlockLengths;
+        // Native code (Jit engine only).
+        std::unique_ptr<chip8::JitCompiler> jitCompiler;
+        // ROM translated ahead of time, used only if compiledRomLoaded (see setCompiledRom).
+        const chip8::CompiledRom* compiledRom;
+        bool compiledRomLoaded;
+        // Non-zero for the addresses where a translated block may have been overwritten since boot.
+        std::vector<uint8_t> modifiedMemory;
 
         // ==================== Private utility functions ====================
       private:
         void initializeRegisters();
         void initializeMemory();
-        void validateMemoryWrite(uint16_t address);
-        void validateStackWrite(uint8_t address);
-        void validateMemoryRead(uint16_t address);
-        void validateStackRead(uint8_t address);
+        DecodedInstruction fetchInstruction();
+        DecodedInstruction fetchDecodedInstruction();
+        void invalidateDecodedInstructions(uint16_t address, size_t length);
+        void step();
+        DecodedInstruction startInstruction();
+        bool isWaiting() const;
+        size_t getBasicBlockLength();
+        size_t runBasicBlock(const size_t maxInstructions);
+        uint8_t findSuperinstruction(const uint16_t address, const uint8_t index) const;
+        size_t runThreaded(const size_t maxInstructions);
+        size_t runCompiledCode(const size_t maxInstructions);
+        size_t runCompiledRom(const size_t maxInstructions);
+        template <typename NativeCode>
+        size_t runNativeCode(const size_t maxInstructions, NativeCode nativeCode);
 
         // ==================== Instruction handling ====================
+        friend class chip8::BasicInstructionSet<BasicCpu>;
+
         void execute_sys_addr(uint16_t addr);
         void execute_cls();
         void execute_ret();
@@ -106,4 +176,10 @@ namespace chip8
         void execute_ld_vx_idata(binding::MatchingPatternType Vx);
         void onUnmatchedInstruction();
     };
+
+    // Peripherals called through their interfaces, so that they can be mocked.
+    using Cpu = BasicCpu<chip8::IGpu, chip8::ITimer>;
+
+    extern template class BasicCpu<chip8::IGpu, chip8::ITimer, chip8::CheckedBounds>;
+    extern template class BasicCpu<chip8::IGpu, chip8::ITimer, chip8::WrappedBounds>;
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#include "Registers.hpp"
+
+namespace chip8
+{
+    // Whole state of a machine, as saved by BasicCpu::save: registers, memory, stack, keys, random generator, timers and framebuffer. It is
+    // a flat value, copied with memcpy, so that saving and restoring cost little more than copying the 4KB of memory, e.g. to rewind or to
+    // explore several inputs from the same state.
+    struct CpuSnapshot
+    {
+        // Of the file format (see writeSnapshot): incremented whenever the layout changes.
+        static constexpr uint32_t Version = 1;
+        static constexpr size_t FrameBufferHeight = 32; // Rows of chip8::Gpu
+
+        uint64_t randomState; // See RandomGenerator::getState
+        std::array<uint64_t, FrameBufferHeight> frameBuffer;
+        std::array<uint8_t, chip8::Registers::MemorySize> memory;
+        std::array<uint8_t, chip8::Registers::StackSize> stack;
+        std::array<uint8_t, 16> V;
+        uint16_t I;
+        uint16_t PC;
+        uint16_t keys; // Bit k set while key k is pressed
+        uint8_t SP;
+        uint8_t delayTimer;
+        uint8_t soundTimer;
+        uint8_t playAudio;
+        uint8_t state;                 // chip8::CpuState
+        std::array<uint8_t, 5> unused; // Padding, made a member so that every byte of a snapshot is defined
+    };
+
+    static_assert(std::is_trivially_copyable_v<chip8::CpuSnapshot>);
+    static_assert(std::has_unique_object_representations_v<chip8::CpuSnapshot>, "Snapshots should have no padding");
+
+    // Files start with "CH8S", the version and the size of the snapshot, then hold its members in order, little-endian.
+    void writeSnapshot(std::ostream& stream, const chip8::CpuSnapshot& snapshot);
+    // Throws SnapshotFormatException if the stream does not hold a snapshot of the current version.
+    chip8::CpuSnapshot readSnapshot(std::istream& stream);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace chip8
+{
+    // How drawing interacts with the frame being executed.
+    enum class DisplayMode
+    {
+        Coalesced,  // Draws only mark the frame dirty: it is shown once, at the end of the frame
+        DisplayWait // As on the COSMAC VIP, DRW waits for the next frame: Cpu::run stops after it
+    };
+}
\ No newline at end of file
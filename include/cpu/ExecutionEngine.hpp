@@ -0,0 +1,14 @@
+#pragma once
+
+namespace chip8
+{
+    // Strategy used by chip8::Cpu to execute instructions. All engines are observably equivalent.
+    enum class ExecutionEngine
+    {
+        Interpreter,       // Fetches and decodes every instruction before executing it
+        CachedInterpreter, // Executes instructions decoded ahead of time, cached by address
+        BasicBlock,        // As CachedInterpreter, but Cpu::run executes straight-line sequences of instructions at once
+        Threaded,          // As CachedInterpreter, but each instruction dispatches the next one without returning to Cpu::run
+        Jit                // Executes blocks translated into native code. Falls back to BasicBlock where not supported (x86-64 Linux only)
+    };
+}
\ No newline at end of file
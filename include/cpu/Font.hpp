@@ -5,7 +5,7 @@
 
 namespace chip8
 {
-    std::array<uint8_t, 80> font = {
+    inline constexpr std::array<uint8_t, 80> font = {
         0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
         0x20, 0x60, 0x20, 0x20, 0x70, // 1
         0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
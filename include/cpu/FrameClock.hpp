@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace chip8
+{
+    // Counts the 60 Hz frames elapsed since the emulator started. Front-ends tick it once per frame, e.g. after executing the
+    // instructions of the frame (see FrameTimer).
+    class FrameClock
+    {
+      public:
+        void tick()
+        {
+            frame++;
+        }
+
+        uint64_t getFrame() const
+        {
+            return frame;
+        }
+
+      private:
+        uint64_t frame = 0;
+    };
+}
\ No newline at end of file
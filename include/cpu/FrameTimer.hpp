@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "FrameClock.hpp"
+#include "ITimer.hpp"
+
+namespace chip8
+{
+    // Timer decremented once per tick of a FrameClock. Unlike Timer, it does not read the system clock: its value is computed when it is
+    // read, so updating it per instruction costs nothing, and runs are deterministic and may go faster than real time.
+    class FrameTimer final : public ITimer
+    {
+      public:
+        explicit FrameTimer(const chip8::FrameClock& clock);
+
+        void setValue(const uint8_t value) override;
+
+        // Called for every instruction: defined here so that they can be inlined.
+        uint8_t getValue() const override
+        {
+            const uint64_t elapsedFrames = clock.getFrame() - frameSet;
+            return static_cast<uint8_t>(valueSet - std::min<uint64_t>(valueSet, elapsedFrames));
+        }
+
+        void updateValue() override
+        {
+        }
+
+      private:
+        const chip8::FrameClock& clock;
+        uint8_t valueSet = 0;
+        uint64_t frameSet = 0;
+    };
+}
\ No newline at end of file
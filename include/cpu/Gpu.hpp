@@ -1,27 +1,56 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <logging/Logger.hpp>
-#include <vector>
+#include <span>
 
 #include "IGpu.hpp"
 
 namespace chip8
 {
-    class Gpu : public IGpu
+    class Gpu final : public IGpu
     {
       public:
+        static constexpr size_t Width = 64;
+        static constexpr size_t Height = 32;
+
         Gpu(const logging::Logger& log);
 
         void clear() override;
-        bool setSprite(const size_t x, const size_t y, const std::vector<uint8_t>& sprite) override;
-        const std::vector<bool>& getFrameBuffer() const override;
+        bool setSprite(const size_t x, const size_t y, const std::span<const uint8_t> sprite) override;
+        std::span<const uint64_t> getFrameBuffer() const override;
+        void setFrameBuffer(const std::span<const uint64_t> frameBuffer) override;
+        uint32_t getDirtyRows() const override;
+        void onDrawComplete() override;
+
+        // Draws the sprite into a framebuffer of Height rows laid out as Gpu's, e.g. one that is not owned by a Gpu (see LockstepCpu), and
+        // adds the rows drawn to drawnRows. Returns true if pixels were erased.
+        static bool drawSprite(const std::span<uint64_t, Height> frameBuffer,
+                               const size_t x,
+                               const size_t y,
+                               const std::span<const uint8_t> sprite,
+                               uint32_t& drawnRows);
+
+        // Defined here, so that they are folded into constants wherever Gpu is not used through IGpu.
+        constexpr size_t getWidth() override
+        {
+            return Width;
+        }
 
-        size_t getWidth() override;
-        size_t getHeight() override;
+        constexpr size_t getHeight() override
+        {
+            return Height;
+        }
 
       private:
         const logging::Logger& logger;
-        std::vector<bool> frameBuffer;
+        // Rows are drawn with word-wide operations, which requires exactly one word per row.
+        static_assert(Width == 64);
+        static_assert(Height <= 32);
+        std::array<uint64_t, Height> frameBuffer;
+        std::array<uint64_t, Height> shownFrameBuffer;
+        // Rows drawn to since the frame was shown, which may or may not have changed.
+        uint32_t drawnRows;
     };
 }
\ No newline at end of file
@@ -8,5 +8,8 @@ namespace chip8
     {
       public:
         virtual bool match(const uint8_t byte1, const uint8_t byte2) = 0;
+
+        // Invokes the callback without checking the pattern. The caller must already know the opcode matches.
+        virtual void bind(const uint8_t byte1, const uint8_t byte2) = 0;
     };
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
+#include <span>
 
 namespace chip8
 {
@@ -9,8 +9,16 @@ namespace chip8
     {
       public:
         virtual void clear() = 0;
-        virtual bool setSprite(const size_t x, const size_t y, const std::vector<uint8_t>& sprite) = 0;
-        virtual const std::vector<bool>& getFrameBuffer() const = 0;
+        virtual bool setSprite(const size_t x, const size_t y, const std::span<const uint8_t> sprite) = 0;
+
+        // One word per row, the leftmost pixel in the most significant bit.
+        virtual std::span<const uint64_t> getFrameBuffer() const = 0;
+        // Replaces the rows, e.g. to restore a snapshot (see CpuSnapshot).
+        virtual void setFrameBuffer(const std::span<const uint64_t> frameBuffer) = 0;
+
+        // Bit y is set if row y differs from the frame shown last, i.e. when onDrawComplete was last called.
+        virtual uint32_t getDirtyRows() const = 0;
+        virtual void onDrawComplete() = 0;
 
         virtual constexpr size_t getWidth() = 0;
         virtual constexpr size_t getHeight() = 0;
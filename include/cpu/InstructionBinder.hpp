@@ -1,11 +1,11 @@
 #pragma once
 
+#include <array>
 #include <functional>
 #include <optional>
 #include <stdint.h>
 #include <tuple>
 #include <utility>
-#include <vector>
 
 #include "IBinder.hpp"
 #include "InstructionBinding.hpp"
@@ -28,40 +28,52 @@ namespace chip8
 
         bool match(const uint8_t byte1, const uint8_t byte2) override
         {
-            return match(byte1, byte2, std::make_index_sequence<sizeof...(T)>());
+            if (!matches(byte1, byte2))
+            {
+                return false;
+            }
+
+            bind(byte1, byte2);
+            return true;
+        }
+
+        void bind(const uint8_t byte1, const uint8_t byte2) override
+        {
+            bind(byte1, byte2, std::make_index_sequence<sizeof...(T)>());
+        }
+
+        static constexpr bool matches(const uint8_t byte1, const uint8_t byte2)
+        {
+            return ((static_cast<uint16_t>(byte1 << 8) | byte2) & Mask) == Value;
         }
 
+        static constexpr uint16_t Mask = binding::patternMask(pattern1, pattern2, pattern3, pattern4);
+        static constexpr uint16_t Value = binding::patternValue(pattern1, pattern2, pattern3, pattern4);
+
       private:
         template <size_t... valueIndex>
-        bool match(const uint8_t byte1, const uint8_t byte2, std::index_sequence<valueIndex...>)
+        void bind(const uint8_t byte1, const uint8_t byte2, std::index_sequence<valueIndex...>)
         {
-            std::vector<binding::MatchingPatternType> boundValues;
-            bool hasMatch = true;
-            hasMatch &= internalMatch((byte1 & 0xF0) >> 4, pattern1, boundValues);
-            hasMatch &= internalMatch(byte1 & 0x0F, pattern2, boundValues);
-            hasMatch &= internalMatch((byte2 & 0xF0) >> 4, pattern3, boundValues);
-            hasMatch &= internalMatch(byte2 & 0x0F, pattern4, boundValues);
+            // Bound values live on the stack: binding an instruction must not allocate.
+            std::array<binding::MatchingPatternType, 4> boundValues;
+            size_t numberOfBoundValues = 0;
+            internalBind((byte1 & 0xF0) >> 4, pattern1, boundValues, numberOfBoundValues);
+            internalBind(byte1 & 0x0F, pattern2, boundValues, numberOfBoundValues);
+            internalBind((byte2 & 0xF0) >> 4, pattern3, boundValues, numberOfBoundValues);
+            internalBind(byte2 & 0x0F, pattern4, boundValues, numberOfBoundValues);
 
-            if (hasMatch)
-            {
-                matchCallback(boundValues[valueIndex]...);
-                return true;
-            }
-
-            return false;
+            matchCallback(boundValues[valueIndex]...);
         }
 
-        bool internalMatch(const binding::MatchingPatternType value,
-                           const binding::MatchingPatternType pattern,
-                           std::vector<binding::MatchingPatternType>& boundValues)
+        static void internalBind(const binding::MatchingPatternType value,
+                                 const binding::MatchingPatternType pattern,
+                                 std::array<binding::MatchingPatternType, 4>& boundValues,
+                                 size_t& numberOfBoundValues)
         {
             if (binding::isPlaceholder(pattern))
             {
-                boundValues.push_back(value);
-                return true;
+                boundValues[numberOfBoundValues++] = value;
             }
-
-            return value == pattern;
         }
 
         std::function<void(T...)> matchCallback;
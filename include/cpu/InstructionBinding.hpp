@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace chip8::binding
@@ -20,4 +21,64 @@ namespace chip8::binding
     {
         return isPlaceholder(unit1) + isPlaceholder(unit2) + isPlaceholder(unit3) + isPlaceholder(unit4);
     }
+
+    // Bits of a 16-bit opcode fixed by the pattern (placeholders are not part of the mask).
+    static constexpr inline uint16_t patternMask(MatchingPatternType unit1, MatchingPatternType unit2, MatchingPatternType unit3, MatchingPatternType unit4)
+    {
+        return (isPlaceholder(unit1) ? 0x0000 : 0xF000) | (isPlaceholder(unit2) ? 0x0000 : 0x0F00) | (isPlaceholder(unit3) ? 0x0000 : 0x00F0) |
+               (isPlaceholder(unit4) ? 0x0000 : 0x000F);
+    }
+
+    // Value the masked bits of an opcode must have to match the pattern.
+    static constexpr inline uint16_t patternValue(MatchingPatternType unit1, MatchingPatternType unit2, MatchingPatternType unit3, MatchingPatternType unit4)
+    {
+        return (isPlaceholder(unit1) ? 0x0000 : unit1 << 12) | (isPlaceholder(unit2) ? 0x0000 : unit2 << 8) | (isPlaceholder(unit3) ? 0x0000 : unit3 << 4) |
+               (isPlaceholder(unit4) ? 0x0000 : unit4);
+    }
+
+    // How an instruction affects the flow of execution. Engines executing several instructions per dispatch must stop after any instruction
+    // that is not sequential.
+    enum class InstructionKind : uint8_t
+    {
+        Sequential, // Execution continues with the next instruction
+        Branch,     // May change the program counter (jumps, calls, returns, skips)
+        Store,      // Writes to memory, possibly over the instructions that follow
+        Wait,       // May suspend execution until the front-end reacts (draw, key press)
+        Trap        // Throws a chip8::CpuExecutionException
+    };
+
+    // Operands of an instruction, named after the notation in doc/Chip8.pdf. Which ones are meaningful depends on the instruction.
+    struct Operands
+    {
+        uint16_t nnn; // Lowest 12 bits of the opcode (address)
+        uint8_t x;    // Lower nibble of the first byte (register)
+        uint8_t y;    // Upper nibble of the second byte (register)
+        uint8_t n;    // Lower nibble of the second byte
+        uint8_t kk;   // Second byte
+
+        static constexpr Operands decode(const uint8_t byte1, const uint8_t byte2)
+        {
+            return {static_cast<uint16_t>(((byte1 & 0x0F) << 8) | byte2),
+                    static_cast<uint8_t>(byte1 & 0x0F),
+                    static_cast<uint8_t>((byte2 & 0xF0) >> 4),
+                    static_cast<uint8_t>(byte2 & 0x0F),
+                    byte2};
+        }
+    };
+
+    // Number of arguments taken by an instruction handler (a member function pointer).
+    template <typename MemberFunctionType>
+    struct HandlerArity;
+
+    template <typename HandlerType, typename ReturnType, typename... Args>
+    struct HandlerArity<ReturnType (HandlerType::*)(Args...)>
+    {
+        static constexpr size_t value = sizeof...(Args);
+    };
+
+    template <typename HandlerType, typename ReturnType, typename... Args>
+    struct HandlerArity<ReturnType (HandlerType::*)(Args...) const>
+    {
+        static constexpr size_t value = sizeof...(Args);
+    };
 }
\ No newline at end of file
@@ -1,13 +1,463 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <type_traits>
-#include <cstdint>
+#include <utility>
 
-#include "InstructionBinder.hpp"
+#include "InstructionBinding.hpp"
 
 namespace chip8
 {
+    // Instruction set bound at compile time to the member functions of HandlerType (e.g. chip8::Cpu::execute_cls). Each instruction is dispatched
+    // through a function generated for its pattern, in which the call to the handler member function can be inlined.
+    // The tables do not depend on the handler instance: they are built at compile time and shared by all handlers (see getInstance).
+    template <typename HandlerType>
+    class BasicInstructionSet
+    {
+      public:
+        using Callback = void (*)(HandlerType& handler, const binding::Operands& operands);
+
+        // Opcodes matching an instruction: those whose bits under mask are value.
+        struct Pattern
+        {
+            uint16_t value;
+            uint16_t mask;
+        };
+
+        // An instruction decoded ahead of execution: executing it is a single call, without decoding the opcode again.
+        struct DecodedInstruction
+        {
+            Callback callback;
+            binding::Operands operands;
+            uint8_t index; // Position of the instruction in the set (see getCallback)
+        };
+
+        static const BasicInstructionSet& getInstance()
+        {
+            return instance;
+        }
+
+        // Instructions are numbered from 0 to getNumberOfInstructions() - 1, 0 being opcodes not matching any instruction. Their callbacks
+        // are known at compile time, so that engines dispatching on the index can call (and inline) them directly.
+        static constexpr size_t getNumberOfInstructions()
+        {
+            return instance.numberOfInstructions;
+        }
+
+        template <size_t index>
+        static constexpr Callback getCallback()
+        {
+            static_assert(index < getNumberOfInstructions(), "No instruction at this index");
+            return instance.callbacks[index];
+        }
+
+        static constexpr uint8_t getIndex(const uint16_t opcode)
+        {
+            return instance.decodeTable[opcode];
+        }
+
+        // Opcode bits identifying the instruction at index (see binding::patternValue and binding::patternMask).
+        static constexpr Pattern getPattern(const size_t index)
+        {
+            return instance.patterns[index];
+        }
+
+        constexpr BasicInstructionSet()
+        {
+            callbacks[UnmatchedInstruction] = &invokeUnmatched;
+            kinds[UnmatchedInstruction] = binding::InstructionKind::Trap;
+
+            // Instruction opcode->callback mapping.The definition below should match what in doc/Chip8.pdf at page 4
+            // For example createInstruction<0x0, n, n, n> for execute_sys_addr reads as
+            // Instruction SYS addr is in the format 0nnn where nnn is a 16-bit address
+            // Instructions not executing sequentially specify their kind (see binding::InstructionKind).
+
+            createInstruction<0x0, 0x0, 0xe, 0x0, &HandlerType::execute_cls>();
+            createInstruction<0x0, 0x0, 0xe, 0xe, &HandlerType::execute_ret, binding::InstructionKind::Branch>();
+            createInstruction<0x0, n, n, n, &HandlerType::execute_sys_addr, binding::InstructionKind::Trap>();
+            createInstruction<0x1, n, n, n, &HandlerType::execute_jp_addr, binding::InstructionKind::Branch>();
+            createInstruction<0x2, n, n, n, &HandlerType::execute_call_addr, binding::InstructionKind::Branch>();
+            createInstruction<0x3, x, k, k, &HandlerType::execute_se_vx_byte, binding::InstructionKind::Branch>();
+            createInstruction<0x4, x, k, k, &HandlerType::execute_sne_vx_byte, binding::InstructionKind::Branch>();
+            createInstruction<0x5, x, y, 0x0, &HandlerType::execute_se_vx_vy, binding::InstructionKind::Branch>();
+            createInstruction<0x6, x, k, k, &HandlerType::execute_ld_vx_byte>();
+            createInstruction<0x7, x, k, k, &HandlerType::execute_add_vx_byte>();
+            createInstruction<0x8, x, y, 0x0, &HandlerType::execute_ld_vx_vy>();
+            createInstruction<0x8, x, y, 0x1, &HandlerType::execute_or_vx_vy>();
+            createInstruction<0x8, x, y, 0x2, &HandlerType::execute_and_vx_vy>();
+            createInstruction<0x8, x, y, 0x3, &HandlerType::execute_xor_vx_vy>();
+            createInstruction<0x8, x, y, 0x4, &HandlerType::execute_add_vx_vy>();
+            createInstruction<0x8, x, y, 0x5, &HandlerType::execute_sub_vx_vy>();
+            createInstruction<0x8, x, y, 0x6, &HandlerType::execute_shr_vx_vy>();
+            createInstruction<0x8, x, y, 0x7, &HandlerType::execute_subn_vx_vy>();
+            createInstruction<0x8, x, y, 0xe, &HandlerType::execute_shl_vx_vy>();
+            createInstruction<0x9, x, y, 0x0, &HandlerType::execute_sne_vx_vy, binding::InstructionKind::Branch>();
+            createInstruction<0xa, n, n, n, &HandlerType::execute_ld_i_addr>();
+            createInstruction<0xb, n, n, n, &HandlerType::execute_jp_v0_addr, binding::InstructionKind::Branch>();
+            createInstruction<0xc, x, k, k, &HandlerType::execute_rnd_vx_byte>();
+            createInstruction<0xd, x, y, n, &HandlerType::execute_drw_vx_vy_nibble, binding::InstructionKind::Wait>();
+            createInstruction<0xe, x, 0x9, 0xe, &HandlerType::execute_skp_vx, binding::InstructionKind::Branch>();
+            createInstruction<0xe, x, 0xa, 0x1, &HandlerType::execute_sknp_vx, binding::InstructionKind::Branch>();
+            createInstruction<0xf, x, 0x0, 0x7, &HandlerType::execute_ld_vx_dt>();
+            createInstruction<0xf, x, 0x0, 0xa, &HandlerType::execute_ld_vx_k, binding::InstructionKind::Wait>();
+            createInstruction<0xf, x, 0x1, 0x5, &HandlerType::execute_ld_dt_vx>();
+            createInstruction<0xf, x, 0x1, 0x8, &HandlerType::execute_ld_st_vx>();
+            createInstruction<0xf, x, 0x1, 0xe, &HandlerType::execute_add_i_vx>();
+            createInstruction<0xf, x, 0x2, 0x9, &HandlerType::execute_ld_f_vx>();
+            createInstruction<0xf, x, 0x3, 0x3, &HandlerType::execute_ld_b_vx, binding::InstructionKind::Store>();
+            createInstruction<0xf, x, 0x5, 0x5, &HandlerType::execute_ld_idata_vx, binding::InstructionKind::Store>();
+            createInstruction<0xf, x, 0x6, 0x5, &HandlerType::execute_ld_vx_idata>();
+        }
+
+        void matchInstruction(HandlerType& handler, uint8_t byte1, uint8_t byte2) const
+        {
+            const DecodedInstruction instruction = decode(byte1, byte2);
+            instruction.callback(handler, instruction.operands);
+        }
+
+        DecodedInstruction decode(uint8_t byte1, uint8_t byte2) const
+        {
+            const uint8_t index = decodeTable[(static_cast<uint16_t>(byte1) << 8) | byte2];
+            return {callbacks[index], binding::Operands::decode(byte1, byte2), index};
+        }
+
+        binding::InstructionKind getKind(uint8_t byte1, uint8_t byte2) const
+        {
+            return kinds[decodeTable[(static_cast<uint16_t>(byte1) << 8) | byte2]];
+        }
+
+      private:
+        template <binding::MatchingPatternType u1,
+                  binding::MatchingPatternType u2,
+                  binding::MatchingPatternType u3,
+                  binding::MatchingPatternType u4,
+                  auto f,
+                  binding::InstructionKind kind = binding::InstructionKind::Sequential>
+        requires(binding::BindingUnitTypeConcept<u1>&& binding::BindingUnitTypeConcept<u2>&& binding::BindingUnitTypeConcept<u3>&&
+                     binding::BindingUnitTypeConcept<u4>) constexpr void createInstruction()
+        {
+            const uint8_t instructionIndex = numberOfInstructions++;
+            callbacks[instructionIndex] = &invoke<u1, u2, u3, u4, f>;
+            kinds[instructionIndex] = kind;
+            patterns[instructionIndex] = {binding::patternValue(u1, u2, u3, u4), binding::patternMask(u1, u2, u3, u4)};
+
+            // Assign every opcode matching the pattern to this instruction, unless an instruction created earlier already claimed it
+            // (e.g. 00E0 is CLS, not SYS 0E0). The loop enumerates all the values the placeholder bits can take.
+            constexpr uint16_t placeholderBits = static_cast<uint16_t>(~binding::patternMask(u1, u2, u3, u4));
+            uint16_t placeholderValue = 0;
+            do
+            {
+                uint8_t& entry = decodeTable[binding::patternValue(u1, u2, u3, u4) | placeholderValue];
+                if (entry == UnmatchedInstruction)
+                {
+                    entry = instructionIndex;
+                }
+
+                placeholderValue = (placeholderValue - placeholderBits) & placeholderBits;
+            } while (placeholderValue != 0);
+        }
+
+        // Placeholders are passed to the handler one nibble each, unless the handler takes fewer arguments than there are placeholders:
+        // three placeholders bound to one argument form an address (nnn), bound to two arguments a register and a byte (x, kk).
+        template <binding::MatchingPatternType u1, binding::MatchingPatternType u2, binding::MatchingPatternType u3, binding::MatchingPatternType u4, auto f>
+        static void invoke(HandlerType& handler, const binding::Operands& operands)
+        {
+            constexpr size_t numberOfPlaceholders = binding::numberOfPlaceHolders(u1, u2, u3, u4);
+            constexpr size_t arity = binding::HandlerArity<decltype(f)>::value;
+
+            if constexpr (numberOfPlaceholders == 3 && arity == 1)
+            {
+                (handler.*f)(operands.nnn);
+            }
+            else if constexpr (numberOfPlaceholders == 3 && arity == 2)
+            {
+                (handler.*f)(operands.x, operands.kk);
+            }
+            else
+            {
+                static_assert(numberOfPlaceholders == arity, "Handler arguments do not match the instruction pattern");
+                static_assert(!binding::isPlaceholder(u1), "The first nibble identifies the instruction and cannot be a placeholder");
+                constexpr std::array<binding::MatchingPatternType, 4> pattern = {u1, u2, u3, u4};
+                const std::array<binding::MatchingPatternType, 4> nibbles = {u1, operands.x, operands.y, operands.n};
+                invokeWithNibbles<f>(handler, nibbles, placeholderPositions<pattern, arity>(), std::make_index_sequence<arity>());
+            }
+        }
+
+        static void invokeUnmatched(HandlerType& handler, const binding::Operands&)
+        {
+            handler.onUnmatchedInstruction();
+        }
+
+        template <auto f, size_t N, size_t... valueIndex>
+        static void invokeWithNibbles(HandlerType& handler,
+                                      const std::array<binding::MatchingPatternType, 4>& nibbles,
+                                      const std::array<size_t, N>& positions,
+                                      std::index_sequence<valueIndex...>)
+        {
+            (handler.*f)(nibbles[positions[valueIndex]]...);
+        }
+
+        template <std::array<binding::MatchingPatternType, 4> pattern, size_t N>
+        static constexpr std::array<size_t, N> placeholderPositions()
+        {
+            std::array<size_t, N> positions{};
+            size_t numberOfPositions = 0;
+            for (size_t i = 0; i < pattern.size(); i++)
+            {
+                if (binding::isPlaceholder(pattern[i]))
+                {
+                    positions[numberOfPositions++] = i;
+                }
+            }
+
+            return positions;
+        }
+
+        // The first callback is reserved to opcodes not matching any instruction.
+        static constexpr size_t MaxInstructions = 256;
+        static constexpr uint8_t UnmatchedInstruction = 0;
+
+        static const BasicInstructionSet instance;
+
+        std::array<Callback, MaxInstructions> callbacks{};
+        std::array<binding::InstructionKind, MaxInstructions> kinds{};
+        std::array<Pattern, MaxInstructions> patterns{};
+        uint8_t numberOfInstructions = UnmatchedInstruction + 1;
+
+        // Opcode -> index in callbacks, so that decoding takes constant time regardless of the number of instructions.
+        std::array<uint8_t, 0x10000> decodeTable{};
+
+        static constexpr binding::MatchingPatternType n = binding::placeholder, k = binding::placeholder, x = binding::placeholder, y = binding::placeholder;
+    };
+
+    template <typename HandlerType>
+    constexpr BasicInstructionSet<HandlerType> BasicInstructionSet<HandlerType>::instance{};
+
+    // Adapts std::function callbacks to the handler interface expected by BasicInstructionSet. Useful to bind instructions to arbitrary callables
+    // (e.g. lambdas in tests) at the cost of an indirect call per instruction.
+    struct InstructionCallbacks
+    {
+        std::function<void(uint16_t addr)> sys_addr_callback;
+        std::function<void()> cls_callback;
+        std::function<void()> ret_callback;
+        std::function<void(uint16_t addr)> jp_addr_callback;
+        std::function<void(uint16_t addr)> call_addr_callback;
+        std::function<void(binding::MatchingPatternType Vx, uint8_t byte)> se_vx_byte_callback;
+        std::function<void(binding::MatchingPatternType Vx, uint8_t byte)> sne_vx_byte_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> se_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, uint8_t byte)> ld_vx_byte_callback;
+        std::function<void(binding::MatchingPatternType Vx, uint8_t byte)> add_vx_byte_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> ld_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> or_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> and_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> xor_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> add_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> sub_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> shr_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> subn_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> shl_vx_vy_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)> sne_vx_vy_callback;
+        std::function<void(uint16_t addr)> ld_i_addr_callback;
+        std::function<void(uint16_t addr)> jp_v0_addr_callback;
+        std::function<void(binding::MatchingPatternType Vx, uint8_t byte)> rnd_vx_byte_callback;
+        std::function<void(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy, binding::MatchingPatternType nibble)> drw_vx_vy_nibble_callback;
+        std::function<void(binding::MatchingPatternType Vx)> skp_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> sknp_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_vx_dt_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_vx_k_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_dt_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_st_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> add_i_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_f_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_b_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_idata_vx_callback;
+        std::function<void(binding::MatchingPatternType Vx)> ld_vx_idata_callback;
+        std::function<void()> unmatchedInstructionCallback;
+
+        void execute_sys_addr(uint16_t addr) const
+        {
+            sys_addr_callback(addr);
+        }
+
+        void execute_cls() const
+        {
+            cls_callback();
+        }
+
+        void execute_ret() const
+        {
+            ret_callback();
+        }
+
+        void execute_jp_addr(uint16_t addr) const
+        {
+            jp_addr_callback(addr);
+        }
+
+        void execute_call_addr(uint16_t addr) const
+        {
+            call_addr_callback(addr);
+        }
+
+        void execute_se_vx_byte(binding::MatchingPatternType Vx, uint8_t byte) const
+        {
+            se_vx_byte_callback(Vx, byte);
+        }
+
+        void execute_sne_vx_byte(binding::MatchingPatternType Vx, uint8_t byte) const
+        {
+            sne_vx_byte_callback(Vx, byte);
+        }
+
+        void execute_se_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            se_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_ld_vx_byte(binding::MatchingPatternType Vx, uint8_t byte) const
+        {
+            ld_vx_byte_callback(Vx, byte);
+        }
+
+        void execute_add_vx_byte(binding::MatchingPatternType Vx, uint8_t byte) const
+        {
+            add_vx_byte_callback(Vx, byte);
+        }
+
+        void execute_ld_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            ld_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_or_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            or_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_and_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            and_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_xor_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            xor_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_add_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            add_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_sub_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            sub_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_shr_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            shr_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_subn_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            subn_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_shl_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            shl_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_sne_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy) const
+        {
+            sne_vx_vy_callback(Vx, Vy);
+        }
+
+        void execute_ld_i_addr(uint16_t addr) const
+        {
+            ld_i_addr_callback(addr);
+        }
+
+        void execute_jp_v0_addr(uint16_t addr) const
+        {
+            jp_v0_addr_callback(addr);
+        }
+
+        void execute_rnd_vx_byte(binding::MatchingPatternType Vx, uint8_t byte) const
+        {
+            rnd_vx_byte_callback(Vx, byte);
+        }
+
+        void execute_drw_vx_vy_nibble(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy, binding::MatchingPatternType nibble) const
+        {
+            drw_vx_vy_nibble_callback(Vx, Vy, nibble);
+        }
+
+        void execute_skp_vx(binding::MatchingPatternType Vx) const
+        {
+            skp_vx_callback(Vx);
+        }
+
+        void execute_sknp_vx(binding::MatchingPatternType Vx) const
+        {
+            sknp_vx_callback(Vx);
+        }
+
+        void execute_ld_vx_dt(binding::MatchingPatternType Vx) const
+        {
+            ld_vx_dt_callback(Vx);
+        }
+
+        void execute_ld_vx_k(binding::MatchingPatternType Vx) const
+        {
+            ld_vx_k_callback(Vx);
+        }
+
+        void execute_ld_dt_vx(binding::MatchingPatternType Vx) const
+        {
+            ld_dt_vx_callback(Vx);
+        }
+
+        void execute_ld_st_vx(binding::MatchingPatternType Vx) const
+        {
+            ld_st_vx_callback(Vx);
+        }
+
+        void execute_add_i_vx(binding::MatchingPatternType Vx) const
+        {
+            add_i_vx_callback(Vx);
+        }
+
+        void execute_ld_f_vx(binding::MatchingPatternType Vx) const
+        {
+            ld_f_vx_callback(Vx);
+        }
+
+        void execute_ld_b_vx(binding::MatchingPatternType Vx) const
+        {
+            ld_b_vx_callback(Vx);
+        }
+
+        void execute_ld_idata_vx(binding::MatchingPatternType Vx) const
+        {
+            ld_idata_vx_callback(Vx);
+        }
+
+        void execute_ld_vx_idata(binding::MatchingPatternType Vx) const
+        {
+            ld_vx_idata_callback(Vx);
+        }
+
+        void onUnmatchedInstruction() const
+        {
+            unmatchedInstructionCallback();
+        }
+    };
+
+    // Instruction set bound at run time to std::function callbacks.
     class InstructionSet
     {
       public:
@@ -48,95 +498,51 @@ namespace chip8
                        std::function<void(binding::MatchingPatternType Vx)> ld_idata_vx_callback,
                        std::function<void(binding::MatchingPatternType Vx)> ld_vx_idata_callback,
                        std::function<void()> unmatchedInstructionCallback)
+            : callbacks{sys_addr_callback,
+                        cls_callback,
+                        ret_callback,
+                        jp_addr_callback,
+                        call_addr_callback,
+                        se_vx_byte_callback,
+                        sne_vx_byte_callback,
+                        se_vx_vy_callback,
+                        ld_vx_byte_callback,
+                        add_vx_byte_callback,
+                        ld_vx_vy_callback,
+                        or_vx_vy_callback,
+                        and_vx_vy_callback,
+                        xor_vx_vy_callback,
+                        add_vx_vy_callback,
+                        sub_vx_vy_callback,
+                        shr_vx_vy_callback,
+                        subn_vx_vy_callback,
+                        shl_vx_vy_callback,
+                        sne_vx_vy_callback,
+                        ld_i_addr_callback,
+                        jp_v0_addr_callback,
+                        rnd_vx_byte_callback,
+                        drw_vx_vy_nibble_callback,
+                        skp_vx_callback,
+                        sknp_vx_callback,
+                        ld_vx_dt_callback,
+                        ld_vx_k_callback,
+                        ld_dt_vx_callback,
+                        ld_st_vx_callback,
+                        add_i_vx_callback,
+                        ld_f_vx_callback,
+                        ld_b_vx_callback,
+                        ld_idata_vx_callback,
+                        ld_vx_idata_callback,
+                        unmatchedInstructionCallback}
         {
-            // Instruction opcode->callback mapping.The definition below should match what in doc/Chip8.pdf at page 4
-            // For example createInstruction<0x0, n, n, n> for sys_addr_callback reads as
-            // Instruction SYS addr is in the format 0nnn where nnn is a 16-bit address
-
-            createInstruction<0x0, 0x0, 0xe, 0x0>(cls_callback);
-            createInstruction<0x0, 0x0, 0xe, 0xe>(ret_callback);
-            createInstruction<0x0, n, n, n>(bindAddressCallback(sys_addr_callback));
-            createInstruction<0x1, n, n, n>(bindAddressCallback(jp_addr_callback));
-            createInstruction<0x2, n, n, n>(bindAddressCallback(call_addr_callback));
-            createInstruction<0x3, x, k, k>(bindRegisterCallback(se_vx_byte_callback));
-            createInstruction<0x4, x, k, k>(bindRegisterCallback(sne_vx_byte_callback));
-            createInstruction<0x5, x, y, 0x0>(se_vx_byte_callback);
-            createInstruction<0x6, x, k, k>(bindRegisterCallback(ld_vx_byte_callback));
-            createInstruction<0x7, x, k, k>(bindRegisterCallback(add_vx_byte_callback));
-            createInstruction<0x8, x, y, 0x0>(ld_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x1>(or_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x2>(and_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x3>(xor_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x4>(add_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x5>(sub_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x6>(shr_vx_vy_callback);
-            createInstruction<0x8, x, y, 0x7>(subn_vx_vy_callback);
-            createInstruction<0x8, x, y, 0xe>(shl_vx_vy_callback);
-            createInstruction<0x9, x, y, 0x0>(sne_vx_vy_callback);
-            createInstruction<0xa, n, n, n>(bindAddressCallback(ld_i_addr_callback));
-            createInstruction<0xb, n, n, n>(bindAddressCallback(jp_v0_addr_callback));
-            createInstruction<0xc, x, k, k>(bindRegisterCallback(rnd_vx_byte_callback));
-            createInstruction<0xd, x, y, n>(drw_vx_vy_nibble_callback);
-            createInstruction<0xe, x, 0x9, 0xe>(skp_vx_callback);
-            createInstruction<0xe, x, 0xa, 0x1>(sknp_vx_callback);
-            createInstruction<0xf, x, 0x0, 0x7>(ld_vx_dt_callback);
-            createInstruction<0xf, x, 0x0, 0xa>(ld_vx_k_callback);
-            createInstruction<0xf, x, 0x1, 0x5>(ld_dt_vx_callback);
-            createInstruction<0xf, x, 0x1, 0x8>(ld_st_vx_callback);
-            createInstruction<0xf, x, 0x1, 0xe>(add_i_vx_callback);
-            createInstruction<0xf, x, 0x2, 0x9>(ld_f_vx_callback);
-            createInstruction<0xf, x, 0x3, 0x3>(ld_b_vx_callback);
-            createInstruction<0xf, x, 0x5, 0x5>(ld_idata_vx_callback);
-            createInstruction<0xf, x, 0x6, 0x5>(ld_vx_idata_callback);
-            this->unmatchedInstructionCallback = unmatchedInstructionCallback;
         }
 
         void matchInstruction(uint8_t byte1, uint8_t byte2) const
         {
-            for (auto& instruction : instructions)
-            {
-                if (instruction->match(byte1, byte2))
-                {
-                    return;
-                }
-            }
-
-            unmatchedInstructionCallback();
-        }
-
-        template <binding::MatchingPatternType u1,
-                  binding::MatchingPatternType u2,
-                  binding::MatchingPatternType u3,
-                  binding::MatchingPatternType u4,
-                  typename T>
-        void createInstruction(T f)
-        {
-            auto instruction = std::make_unique<chip8::InstructionBinder<u1, u2, u3, u4>>(f);
-            instructions.push_back(std::move(instruction));
+            chip8::BasicInstructionSet<const InstructionCallbacks>::getInstance().matchInstruction(callbacks, byte1, byte2);
         }
 
       private:
-        inline std::function<void(binding::MatchingPatternType, binding::MatchingPatternType, binding::MatchingPatternType)>
-        bindAddressCallback(std::function<void(uint16_t)> f)
-        {
-            return [=](const binding::MatchingPatternType n1, const binding::MatchingPatternType n2, const binding::MatchingPatternType n3)
-            {
-                f((static_cast<uint16_t>(n1) << 8) | (static_cast<uint16_t>(n2) << 4) | static_cast<uint16_t>(n3));
-            };
-        }
-
-        inline std::function<void(binding::MatchingPatternType, binding::MatchingPatternType, binding::MatchingPatternType)>
-        bindRegisterCallback(std::function<void(binding::MatchingPatternType, uint8_t)> f)
-        {
-            return [=](const binding::MatchingPatternType n1, const binding::MatchingPatternType n2, const binding::MatchingPatternType n3)
-            {
-                f(n1, static_cast<uint8_t>((n2 << 4) | n3));
-            };
-        }
-
-        std::vector<std::unique_ptr<chip8::IBinder>> instructions;
-        std::function<void()> unmatchedInstructionCallback;
-
-        static constexpr binding::MatchingPatternType n = binding::placeholder, k = binding::placeholder, x = binding::placeholder, y = binding::placeholder;
+        const InstructionCallbacks callbacks;
     };
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <logging/Logger.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "CpuExecutionException.hpp"
+#include "Gpu.hpp"
+#include "Key.hpp"
+#include "RandomGenerator.hpp"
+#include "SimdLevel.hpp"
+
+namespace chip8
+{
+    // Runs many instances of the same ROM together, e.g. thousands of environments stepped with different inputs and seeds. Instances are
+    // called lanes.
+    //
+    // Registers and timers are stored register by register, one element per lane (structure of arrays), so that an instruction is decoded
+    // once and executed on all the lanes whose PC agrees with a few vector operations. Lanes that diverge are regrouped at every instruction:
+    // the lanes with the lowest PC run first, which lets the lanes behind on a branch catch up with the others. Lanes share the memory image
+    // of the ROM and copy a page of it on their first write to the page.
+    //
+    // Each lane runs as BasicCpu<Gpu, FrameTimer, WrappedBounds> with a xorshift generator would, except that errors stop the lane rather
+    // than throw (see getError) and that draws never wait for the display. The framebuffers of the lanes are stored one after the other
+    // (see getFrameBuffers).
+    class LockstepCpu
+    {
+      public:
+        static constexpr size_t MemorySize = 4 * 1024; // 4KB
+        static constexpr size_t StackSize = 64;
+        static constexpr size_t PageSize = 256;
+
+        // State of a lane, which restore copies into any lane: e.g. the state after boot, to start a lane over without reading the ROM again.
+        struct LaneState
+        {
+            std::array<uint8_t, 16> V;
+            uint16_t I;
+            uint16_t PC;
+            uint8_t SP;
+            std::array<uint8_t, StackSize> stack;
+            uint8_t delayTimer;
+            uint8_t soundTimer;
+            std::array<uint64_t, chip8::Gpu::Height> frameBuffer;
+            std::array<uint8_t, MemorySize> memory;
+        };
+
+        LockstepCpu(const logging::Logger& logger, const size_t lanes, const chip8::SimdLevel level = chip8::getSimdLevel());
+
+        // Boots the ROM on every lane, lane i generating random numbers from seeds[i] (see RandomGenerator). Keys are released.
+        void boot(std::istream& stream, const std::span<const uint64_t> seeds);
+        // Executes maxInstructions instructions on every lane, fewer on the lanes that wait for a key press or stop on an error. Returns the
+        // number of instructions executed by all the lanes together.
+        uint64_t run(const size_t maxInstructions);
+        // Decrements the timers of every lane: to be called once per frame, as FrameClock::tick.
+        void tickTimers();
+        void onKeyPressed(const size_t lane, const chip8::Key key);
+        void onKeyReleased(const size_t lane, const chip8::Key key);
+
+        LaneState save(const size_t lane) const;
+        // Replaces the state of the lane, which then generates random numbers from seed, releases its keys and no longer stops on an error.
+        // Pages equal to the ROM image are shared again.
+        void restore(const size_t lane, const LaneState& state, const uint64_t seed);
+
+        size_t getLaneCount() const;
+        bool isWaitingForKey(const size_t lane) const;
+        // Error that stopped the lane: it no longer runs until the next boot.
+        std::optional<chip8::CpuErrorCode> getError(const size_t lane) const;
+        bool shouldPlayAudio(const size_t lane) const;
+        // Rows of the lane's screen, as Gpu::getFrameBuffer.
+        std::span<const uint64_t> getFrameBuffer(const size_t lane) const;
+        // The framebuffers of all the lanes, Gpu::Height rows each, lane after lane.
+        std::span<const uint64_t> getFrameBuffers() const;
+
+        uint8_t getV(const size_t lane, const size_t index) const;
+        uint16_t getI(const size_t lane) const;
+        uint16_t getPC(const size_t lane) const;
+        uint8_t getSP(const size_t lane) const;
+        uint8_t getDelayTimer(const size_t lane) const;
+        uint8_t getSoundTimer(const size_t lane) const;
+        uint8_t readMemory(const size_t lane, const uint16_t address) const;
+
+        // Pages privately copied by the lanes.
+        size_t getPrivatePageCount() const;
+
+      private:
+        static constexpr size_t ProgramStartLocation = 0x200;
+        static constexpr size_t VF = 0xf;
+        static constexpr size_t Pages = MemorySize / PageSize;
+        // Lanes are stored in multiples of the number of bytes of an AVX2 vector, so that vector loops need no remainder.
+        static constexpr size_t LaneAlignment = 32;
+        // Budgets are 16-bit, as PCs, so that both are processed with the same vectors: longer runs are split.
+        static constexpr size_t MaxBudget = 0xFFFF;
+        static constexpr uint16_t NoPC = 0xFFFF;
+
+        using Page = std::array<uint8_t, PageSize>;
+
+        size_t step();
+        size_t selectGroupScalar(uint16_t& PC, size_t& leader);
+        size_t selectGroupAvx2(uint16_t& PC, size_t& leader);
+        size_t excludeModifiedCode(const uint16_t PC, const size_t leader, size_t count);
+        bool executeAvx2(const uint8_t byte1, const uint8_t byte2);
+        void execute(const size_t lane, const uint8_t byte1, const uint8_t byte2);
+        void stop(const size_t lane, const chip8::CpuErrorCode errorCode);
+
+        uint8_t read(const size_t lane, const uint16_t address) const;
+        void write(const size_t lane, const uint16_t address, const uint8_t value);
+        bool isPrivate(const size_t lane, const size_t page) const;
+        void share(const size_t lane, const size_t page);
+        std::span<uint64_t, chip8::Gpu::Height> getLaneFrameBuffer(const size_t lane);
+
+      private:
+        const logging::Logger& logger;
+        const size_t lanes;
+        const size_t stride; // Lanes rounded up to LaneAlignment: the lanes past the last one never run
+        const chip8::SimdLevel level;
+
+        // Element [index * stride + lane] of V and stack.
+        std::vector<uint8_t> V;
+        std::vector<uint16_t> I;
+        std::vector<uint16_t> PC;
+        std::vector<uint8_t> SP;
+        std::vector<uint8_t> stack;
+        std::vector<uint8_t> delayTimer;
+        std::vector<uint8_t> soundTimer;
+        std::vector<uint16_t> keys;   // Bit k set while key k is pressed
+        std::vector<uint16_t> budget; // Instructions left to execute in the current run, 0 for the lanes that do not run
+        std::vector<uint8_t> group;   // 0xFF for the lanes executing the current instruction
+        std::vector<uint8_t> waitingForKey;
+        std::vector<std::optional<chip8::CpuErrorCode>> errors;
+        std::vector<chip8::RandomGenerator> randomGenerators;
+        std::vector<uint64_t> frameBuffers;
+
+        // Memory shared by the lanes, and the page of each lane: [lane * Pages + page] points either into image or to a private copy.
+        std::array<uint8_t, MemorySize> image;
+        std::vector<uint8_t*> pageTable;
+        std::vector<std::unique_ptr<Page>> privatePages; // Kept from one boot to the next
+        std::vector<uint8_t*> freePages;
+        // Lanes with a private copy of each page, whose instructions may differ from the image.
+        std::array<size_t, Pages> privateCopies;
+    };
+}
\ No newline at end of file
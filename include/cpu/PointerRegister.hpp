@@ -1,6 +1,6 @@
 #pragma once
 
-#include <functional>
+#include <cstddef>
 #include <type_traits>
 
 #include "CpuExecutionException.hpp"
@@ -10,14 +10,70 @@ namespace chip8
     template <typename RegisterType>
     concept PointerRegisterConcept = std::is_unsigned<RegisterType>::value;
 
-    template <PointerRegisterConcept RegisterType, CpuErrorCode underflowErrorCode, CpuErrorCode overflowErrorCode>
+    // Bounds policies of PointerRegister. Pointers index an array of size elements: write is applied to the values assigned to the register,
+    // read to the values computed from it (e.g. PC + 1) to be dereferenced, and onWrapAround is called when arithmetic wraps around the
+    // register type.
+
+    // Throws errorCode for pointers out of the array. Pointers may point right past its end (e.g. the stack pointer of a full stack).
+    struct CheckedBounds
+    {
+        template <PointerRegisterConcept RegisterType, size_t size, CpuErrorCode errorCode>
+        static RegisterType write(const RegisterType pointer)
+        {
+            if (pointer > size)
+            {
+                throw CpuExecutionException(errorCode);
+            }
+
+            return pointer;
+        }
+
+        template <PointerRegisterConcept RegisterType, size_t size, CpuErrorCode errorCode>
+        static RegisterType read(const RegisterType pointer)
+        {
+            if (pointer >= size)
+            {
+                throw CpuExecutionException(errorCode);
+            }
+
+            return pointer;
+        }
+
+        template <CpuErrorCode errorCode>
+        static void onWrapAround()
+        {
+            throw CpuExecutionException(errorCode);
+        }
+    };
+
+    // Wraps pointers around the array, whose size must be a power of two: never throws, every pointer can be dereferenced.
+    struct WrappedBounds
+    {
+        template <PointerRegisterConcept RegisterType, size_t size, CpuErrorCode errorCode>
+        static RegisterType write(const RegisterType pointer)
+        {
+            static_assert((size & (size - 1)) == 0, "Pointers can only be wrapped around arrays whose size is a power of two");
+            return static_cast<RegisterType>(pointer & (size - 1));
+        }
+
+        template <PointerRegisterConcept RegisterType, size_t size, CpuErrorCode errorCode>
+        static RegisterType read(const RegisterType pointer)
+        {
+            return write<RegisterType, size, errorCode>(pointer);
+        }
+
+        template <CpuErrorCode errorCode>
+        static void onWrapAround()
+        {
+        }
+    };
+
+    template <PointerRegisterConcept RegisterType, size_t size, CpuErrorCode underflowErrorCode, CpuErrorCode overflowErrorCode, typename BoundsPolicy>
     class PointerRegister
     {
       public:
-        PointerRegister(std::function<void(RegisterType)> writeValidator, std::function<void(RegisterType)> readValidator)
-            : writeValidator(writeValidator)
-            , readValidator(readValidator)
-            , pointer(0)
+        PointerRegister()
+            : pointer(0)
         {
         }
 
@@ -34,12 +90,10 @@ namespace chip8
 
             if (postIncrementValue < pointer)
             {
-                throw CpuExecutionException(overflowErrorCode);
+                BoundsPolicy::template onWrapAround<overflowErrorCode>();
             }
 
-            readValidator(postIncrementValue);
-
-            return postIncrementValue;
+            return BoundsPolicy::template read<RegisterType, size, overflowErrorCode>(postIncrementValue);
         }
 
         RegisterType operator-(const RegisterType& value) const
@@ -50,18 +104,15 @@ namespace chip8
 
             if (postDecrementValue > pointer)
             {
-                throw CpuExecutionException(underflowErrorCode);
+                BoundsPolicy::template onWrapAround<underflowErrorCode>();
             }
 
-            readValidator(postDecrementValue);
-
-            return postDecrementValue;
+            return BoundsPolicy::template read<RegisterType, size, overflowErrorCode>(postDecrementValue);
         }
 
         PointerRegister& operator=(const RegisterType value)
         {
-            writeValidator(value);
-            pointer = value;
+            pointer = BoundsPolicy::template write<RegisterType, size, overflowErrorCode>(value);
             return *this;
         }
 
@@ -73,12 +124,10 @@ namespace chip8
 
             if (postIncrementValue < pointer)
             {
-                throw CpuExecutionException(overflowErrorCode);
+                BoundsPolicy::template onWrapAround<overflowErrorCode>();
             }
 
-            writeValidator(postIncrementValue);
-
-            pointer = postIncrementValue;
+            pointer = BoundsPolicy::template write<RegisterType, size, overflowErrorCode>(postIncrementValue);
 
             return *this;
         }
@@ -91,19 +140,15 @@ namespace chip8
 
             if (postDecrementValue > pointer)
             {
-                throw CpuExecutionException(overflowErrorCode);
+                BoundsPolicy::template onWrapAround<overflowErrorCode>();
             }
 
-            writeValidator(postDecrementValue);
-
-            pointer = postDecrementValue;
+            pointer = BoundsPolicy::template write<RegisterType, size, overflowErrorCode>(postDecrementValue);
 
             return *this;
         }
 
       private:
         RegisterType pointer;
-        std::function<void(RegisterType)> writeValidator;
-        std::function<void(RegisterType)> readValidator;
     };
 }
\ No newline at end of file
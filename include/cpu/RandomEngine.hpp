@@ -0,0 +1,11 @@
+#pragma once
+
+namespace chip8
+{
+    // Generator of the numbers returned by RND Vx, byte (see chip8::RandomGenerator).
+    enum class RandomEngine
+    {
+        Xorshift, // xorshift64*: 8 bytes of state, cheap to seed
+        Standard  // std::default_random_engine
+    };
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "RandomEngine.hpp"
+
+namespace chip8
+{
+    // Random numbers of a Cpu. Instances seeded identically generate the same numbers, so that runs can be reproduced.
+    class RandomGenerator
+    {
+      public:
+        static constexpr uint64_t DefaultSeed = 0;
+
+        explicit RandomGenerator(const chip8::RandomEngine engine = chip8::RandomEngine::Xorshift, const uint64_t seed = DefaultSeed);
+
+        // Seed read from std::random_device, for runs that should not be reproducible.
+        static uint64_t createRandomSeed();
+
+        uint8_t next();
+
+        // Xorshift state, e.g. for snapshots (see CpuSnapshot): a generator given the state of another generates the same numbers from
+        // then on. Throw std::logic_error with the standard engine, whose state is implementation-defined.
+        uint64_t getState() const;
+        void setState(const uint64_t state);
+
+      private:
+        uint64_t state; // Xorshift only
+        // Standard only. Allocated separately, since the state of std::default_random_engine may be larger than the whole machine.
+        std::unique_ptr<std::default_random_engine> standardEngine;
+    };
+}
\ No newline at end of file
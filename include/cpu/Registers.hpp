@@ -6,23 +6,25 @@
 
 namespace chip8
 {
-	struct Registers
+	// Bounds checks are performed unless built with CHIP8_WRAPPED_ADDRESSES (see chip8::WrappedBounds).
+#ifdef CHIP8_WRAPPED_ADDRESSES
+	using DefaultBoundsPolicy = chip8::WrappedBounds;
+#else
+	using DefaultBoundsPolicy = chip8::CheckedBounds;
+#endif
+
+	template <typename BoundsPolicy>
+	struct BasicRegisters
 	{
 	public:
-		Registers(std::function<void(uint16_t)> memoryWriteValidator,
-			std::function<void(uint16_t)> memoryReadValidator,
-			std::function<void(uint8_t)> stackWriteValidator,
-			std::function<void(uint8_t)> stackReadValidator)
-			: V()
-			, I(memoryWriteValidator, memoryReadValidator)
-			, PC(memoryWriteValidator, memoryReadValidator)
-			, SP(stackWriteValidator, stackReadValidator)
-		{
-		}
+		static constexpr size_t MemorySize = 4 * 1024; // 4KB
+		static constexpr size_t StackSize = 64;
 
-		std::array<uint8_t, 16> V;                                                                      // General purpose registers
-		PointerRegister<uint16_t, CpuErrorCode::AddressOutOfBound, CpuErrorCode::AddressOutOfBound> I;  // Pointer regiter
-		PointerRegister<uint16_t, CpuErrorCode::AddressOutOfBound, CpuErrorCode::AddressOutOfBound> PC; // Program counter
-		PointerRegister<uint8_t, CpuErrorCode::StackUnderflow, CpuErrorCode::StackOverflow> SP;         // Stack pointer
+		std::array<uint8_t, 16> V;                                                                                                // General purpose registers
+		PointerRegister<uint16_t, MemorySize, CpuErrorCode::AddressOutOfBound, CpuErrorCode::AddressOutOfBound, BoundsPolicy> I;  // Pointer regiter
+		PointerRegister<uint16_t, MemorySize, CpuErrorCode::AddressOutOfBound, CpuErrorCode::AddressOutOfBound, BoundsPolicy> PC; // Program counter
+		PointerRegister<uint8_t, StackSize, CpuErrorCode::StackUnderflow, CpuErrorCode::StackOverflow, BoundsPolicy> SP;          // Stack pointer
 	};
+
+	using Registers = BasicRegisters<DefaultBoundsPolicy>;
 }
\ No newline at end of file
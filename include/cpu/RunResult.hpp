@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace chip8
+{
+    // Why Cpu::run returned. Execution errors are reported by exceptions (see CpuExecutionException).
+    enum class StopReason
+    {
+        BudgetExhausted, // maxInstructions instructions have been executed
+        WaitForKey,      // LD Vx, K is waiting for a key press: running further would only repeat it
+        WaitForDraw      // DRW is waiting for the next frame (see DisplayMode::DisplayWait)
+    };
+
+    struct RunResult
+    {
+        size_t instructions;
+        StopReason stopReason;
+        bool audioChanged; // shouldPlayAudio() changed during the run
+        bool frameDirty;   // The frame buffer changed during the run
+    };
+}
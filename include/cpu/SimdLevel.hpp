@@ -0,0 +1,15 @@
+#pragma once
+
+namespace chip8
+{
+    // Instruction sets of the vectorized code paths, from the slowest to the fastest.
+    enum class SimdLevel
+    {
+        None,
+        Sse2,
+        Avx2
+    };
+
+    // Fastest level supported by the host.
+    SimdLevel getSimdLevel();
+}
\ No newline at end of file
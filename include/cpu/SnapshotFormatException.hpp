@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace chip8
+{
+    class SnapshotFormatException : public std::runtime_error
+    {
+      public:
+        explicit SnapshotFormatException(const std::string& message)
+            : std::runtime_error("Error reading snapshot: " + message)
+        {
+        }
+    };
+}
\ No newline at end of file
@@ -7,7 +7,8 @@
 
 namespace chip8
 {
-    class Timer : public ITimer
+    // Timer decremented at 60 Hz of wall-clock time, checked on every update.
+    class Timer final : public ITimer
     {
       public:
         void setValue(const uint8_t value) override;
@@ -18,7 +19,7 @@ namespace chip8
         static constexpr uint64_t TickFrequency = 60;
         static constexpr uint64_t TickPeriod = static_cast<uint64_t>(1.0 / static_cast<double>(TickFrequency) * 1000);
 
-        std::chrono::time_point<std::chrono::system_clock> latestCounterDecrement = std::chrono::system_clock::now();
+        std::chrono::time_point<std::chrono::steady_clock> latestCounterDecrement = std::chrono::steady_clock::now();
         uint8_t counter = 0;
     };
 }
\ No newline at end of file
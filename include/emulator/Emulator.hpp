@@ -3,6 +3,13 @@
 #include <memory>
 #include <vector>
 
+#include "OverrunPolicy.hpp"
+#include "Palette.hpp"
+#include "TimerMode.hpp"
+#include "cpu/DisplayMode.hpp"
+#include "cpu/ExecutionEngine.hpp"
+#include "cpu/FrameClock.hpp"
+#include "cpu/RandomGenerator.hpp"
 #include "logging/Logger.hpp"
 
 namespace chip8
@@ -13,12 +20,33 @@ namespace chip8
         Emulator(const logging::Logger& logger, const std::string& romFileName);
         ~Emulator();
 
-        void run(const std::string& programName, const std::string& version, const uint32_t clock);
+        void run(const std::string& programName,
+                 const std::string& version,
+                 const uint32_t clock,
+                 const chip8::OverrunPolicy overrunPolicy,
+                 const chip8::ExecutionEngine engine,
+                 const chip8::TimerMode timerMode,
+                 const chip8::DisplayMode displayMode,
+                 const chip8::RandomEngine randomEngine,
+                 const uint64_t seed,
+                 const chip8::Palette& palette);
 
       private:
         Emulator(const Emulator&) = delete;
         Emulator& operator=(const Emulator&) = delete;
 
+        template <typename TimerType>
+        void runCpu(const std::string& programName,
+                    const std::string& version,
+                    const uint32_t clock,
+                    const chip8::OverrunPolicy overrunPolicy,
+                    const chip8::ExecutionEngine engine,
+                    const chip8::DisplayMode displayMode,
+                    chip8::RandomGenerator randomGenerator,
+                    const chip8::Palette& palette,
+                    chip8::FrameClock& frameClock,
+                    TimerType& soundTimer,
+                    TimerType& delayTimer);
         std::unique_ptr<std::ifstream> loadRom() const;
 
         const logging::Logger& logger;
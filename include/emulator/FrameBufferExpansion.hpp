@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cpu/SimdLevel.hpp>
+#include <span>
+
+#include "Palette.hpp"
+
+namespace chip8
+{
+    // Writes one ARGB8888 pixel per bit of the framebuffer (see IGpu::getFrameBuffer) into pixels, whose rows are pitch bytes apart, e.g.
+    // the memory of a locked SDL texture. The level must be supported by the host.
+    void expandFrameBuffer(const std::span<const uint64_t> frameBuffer,
+                           const chip8::Palette& palette,
+                           uint32_t* pixels,
+                           const size_t pitch,
+                           const chip8::SimdLevel level = getSimdLevel());
+}
\ No newline at end of file
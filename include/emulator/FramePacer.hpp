@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "OverrunPolicy.hpp"
+
+namespace chip8
+{
+    // Schedules the 60 Hz frames of the emulation and the instructions executed during each of them, so that the CPU executes the
+    // requested number of instructions per second on average.
+    class FramePacer
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t FrameRate = 60;
+        static constexpr Clock::duration FrameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / FrameRate;
+        // Late frames beyond which CatchUp gives up and starts again from the current time, e.g. after the host was suspended.
+        static constexpr uint64_t MaxCatchUpFrames = FrameRate;
+
+        FramePacer(const uint32_t instructionsPerSecond, const chip8::OverrunPolicy overrunPolicy, const Clock::time_point start = Clock::now());
+
+        // Instructions to execute in the next frame: instructionsPerSecond / FrameRate, the remainder of the division being carried over
+        // to the next frames.
+        uint32_t getFrameInstructions();
+
+        // Records the end of a frame and returns when the next one starts, applying the overrun policy if it is late.
+        Clock::time_point onFrameExecuted(const uint64_t executedInstructions, const Clock::time_point now = Clock::now());
+
+        // Sleeps until deadline, then spins for the last part of the wait, which sleeping is not accurate enough for.
+        static void waitUntil(const Clock::time_point deadline);
+
+        uint32_t getRequestedRate() const;
+        // Instructions executed per second since the start.
+        double getAchievedRate(const Clock::time_point now = Clock::now()) const;
+        uint64_t getDroppedFrames() const;
+
+      private:
+        static constexpr Clock::duration SpinDuration = std::chrono::milliseconds(2);
+
+        const uint32_t instructionsPerSecond;
+        const chip8::OverrunPolicy overrunPolicy;
+        const Clock::time_point start;
+
+        uint32_t instructionsCarry;
+        Clock::time_point nextFrame;
+        uint64_t executedInstructions;
+        uint64_t droppedFrames;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <span>
+
+#include "InputScript.hpp"
+#include "cpu/Cpu.hpp"
+#include "cpu/DisplayMode.hpp"
+#include "cpu/ExecutionEngine.hpp"
+#include "cpu/FrameClock.hpp"
+#include "cpu/FrameTimer.hpp"
+#include "cpu/Gpu.hpp"
+#include "cpu/RandomGenerator.hpp"
+#include "logging/Logger.hpp"
+
+namespace chip8
+{
+    // Runs a ROM without window, audio nor event loop, e.g. on build hosts without display: the CPU executes virtual 60 Hz frames of
+    // clock / 60 instructions, with the keys of an input script. Timers tick once per virtual frame, so that runs are deterministic
+    // (see FrameTimer), whether they go as fast as possible or in real time.
+    class HeadlessEmulator
+    {
+      public:
+        using CpuType = chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>;
+
+        struct Report
+        {
+            uint64_t instructions;
+            uint64_t frames;          // Virtual frames executed
+            uint64_t drawnFrames;     // Frames that ended with a frame buffer different from the previous drawn one
+            uint64_t frameBufferHash; // Of the final frame buffer (see hashFrameBuffer)
+            bool waitingForKey;       // Stopped early: the program waits for a key that the input script never presses
+            double seconds;
+        };
+
+        HeadlessEmulator(const logging::Logger& logger, const chip8::ExecutionEngine engine, const chip8::DisplayMode displayMode);
+
+        // Resets the whole machine, screen and timers included, so that an instance can run one ROM after the other as if it was new.
+        void boot(std::istream& rom, chip8::RandomGenerator randomGenerator);
+
+        // Runs until maxFrames frames or maxInstructions instructions have been executed, 0 meaning no limit. If realTime is set, frames
+        // are paced at 60 Hz as in the emulator window, otherwise they are executed back to back.
+        Report run(const chip8::InputScript& input, const uint32_t clock, const uint64_t maxFrames, const uint64_t maxInstructions, const bool realTime);
+
+        // 64-bit FNV-1a of the pixels, row by row from the leftmost pixel, so that hashes are the same on every host.
+        static uint64_t hashFrameBuffer(std::span<const uint64_t> frameBuffer);
+
+        HeadlessEmulator(const HeadlessEmulator&) = delete;
+        HeadlessEmulator& operator=(const HeadlessEmulator&) = delete;
+
+      private:
+        chip8::Gpu gpu;
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer;
+        chip8::FrameTimer delayTimer;
+        CpuType cpu;
+    };
+}
\ No newline at end of file
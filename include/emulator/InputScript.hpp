@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#include "cpu/Key.hpp"
+
+namespace chip8
+{
+    // Key presses and releases replayed at given frames, e.g. by HeadlessEmulator. One event per line, as "<frame> <key> down|up" with the
+    // key in hexadecimal: "120 5 down". Empty lines and lines starting with # are ignored.
+    class InputScript
+    {
+      public:
+        struct KeyEvent
+        {
+            uint64_t frame;
+            chip8::Key key;
+            bool pressed;
+        };
+
+        // No events: programs waiting for a key wait forever.
+        InputScript() = default;
+        // Throws InputScriptException if a line is malformed.
+        explicit InputScript(std::istream& script);
+
+        // Sorted by frame, in the order of the script within a frame.
+        const std::vector<KeyEvent>& getEvents() const;
+
+      private:
+        std::vector<KeyEvent> events;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace chip8
+{
+    class InputScriptException : public std::runtime_error
+    {
+      public:
+        explicit InputScriptException(const std::string& message)
+            : std::runtime_error("Error reading input script: " + message)
+        {
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace chip8
+{
+    // What the emulator does when frames take longer than their 1/60 s to execute, e.g. when the host is under load.
+    enum class OverrunPolicy
+    {
+        CatchUp, // Runs the late frames back to back until it is on time again, so that the emulated time keeps up with real time
+        Drop     // Skips the late frames, so that the emulation slows down rather than running in bursts
+    };
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace chip8
+{
+    // Colors of the screen, in ARGB8888.
+    struct Palette
+    {
+        uint32_t foreground = 0xFFFFFFFF; // Pixels that are on
+        uint32_t background = 0xFF000000; // Pixels that are off
+    };
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace chip8
+{
+    // How the delay and sound timers count down.
+    enum class TimerMode
+    {
+        Frame,    // Once per emulated frame (see chip8::FrameTimer): deterministic, independent from the host speed
+        WallClock // At 60 Hz of real time (see chip8::Timer)
+    };
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace chip8
+{
+    // Hands values from one writer thread to one reader thread without locks or waiting. The writer fills its buffer and publishes it,
+    // the reader takes the latest published one: values published in between are skipped.
+    template <typename T>
+    class TripleBuffer
+    {
+      public:
+        // Writer side.
+        T& getWriteBuffer()
+        {
+            return buffers[writeIndex];
+        }
+
+        void publish()
+        {
+            writeIndex = shared.exchange(writeIndex | Fresh, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        // Reader side: returns the latest value published since the last call, or nullptr if none. The value stays valid until the next
+        // call.
+        const T* read()
+        {
+            if ((shared.load(std::memory_order_relaxed) & Fresh) == 0)
+            {
+                return nullptr;
+            }
+
+            readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+            return &buffers[readIndex];
+        }
+
+      private:
+        static constexpr uint8_t IndexMask = 0x3;
+        static constexpr uint8_t Fresh = 0x4; // Set in shared when it holds a value the reader has not read
+
+        std::array<T, 3> buffers{};
+        std::atomic<uint8_t> shared{1}; // Index of the buffer exchanged between the writer and the reader
+        uint8_t writeIndex = 0;
+        uint8_t readIndex = 2;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cpu/LockstepCpu.hpp>
+#include <cpu/SimdLevel.hpp>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <logging/Logger.hpp>
+#include <span>
+#include <vector>
+
+namespace chip8::env
+{
+    // A byte of the machine state of an instance, e.g. where a ROM keeps its score.
+    struct Location
+    {
+        enum class Kind
+        {
+            Register, // V[index]
+            Memory    // Memory at address index
+        };
+
+        Kind kind;
+        uint16_t index;
+    };
+
+    // Hooks get the values of the watched locations of an instance, in the order of VecEnvOptions::watched, at the end of the step and at
+    // the end of the previous one, or at reset.
+    using RewardHook = std::function<float(std::span<const uint8_t> current, std::span<const uint8_t> previous)>;
+    using DoneHook = std::function<bool(std::span<const uint8_t> current)>;
+
+    struct VecEnvOptions
+    {
+        size_t instructionsPerFrame = 16; // About the emulator's default clock
+        size_t framesPerStep = 4;
+        // Frames run without keys after boot, e.g. to skip a title screen: instances are reset to the state reached then.
+        size_t startFrames = 0;
+        std::vector<chip8::env::Location> watched;
+        chip8::env::RewardHook reward; // Rewards are 0 without hook
+        chip8::env::DoneHook done;     // Episodes only end on errors without hook
+    };
+
+    // Views of the state of the environment, valid until the next step or reset.
+    struct StepResult
+    {
+        // Gpu::Height rows per instance, instance after instance, a row being 64 pixels from its most significant bit as in
+        // Gpu::getFrameBuffer.
+        std::span<const uint64_t> observations;
+        std::span<const float> rewards;
+        std::span<const uint8_t> done; // 1 for the instances whose episode ended, e.g. on a CPU error
+    };
+
+    // Steps many instances of a ROM together for reinforcement learning, on a LockstepCpu whose lanes are the instances.
+    //
+    // The ROM is only read at construction: resets restore the state saved after the start frames, with a new seed for each episode.
+    // Observations are the framebuffers of the lanes themselves, which are stored contiguously, so that they are never copied.
+    class VecEnv
+    {
+      public:
+        // Instance i starts its first episode from seed + i, and every reset uses the next seed. Throws RomLoadFailureException if the ROM
+        // does not fit in memory, std::invalid_argument if a watched location is not a register or an address of memory.
+        VecEnv(const logging::Logger& logger,
+               std::istream& rom,
+               const size_t instances,
+               const uint64_t seed,
+               chip8::env::VecEnvOptions options,
+               const chip8::SimdLevel level = chip8::getSimdLevel());
+
+        // Starts a new episode on every instance. Rewards and done are 0.
+        chip8::env::StepResult reset();
+        // Resets the instances whose episode ended at the previous step, then runs framesPerStep frames with the keys of actions[i] pressed on
+        // instance i, bit k for key k. Throws std::invalid_argument unless there is one action per instance.
+        chip8::env::StepResult step(const std::span<const uint16_t> actions);
+
+        size_t getInstanceCount() const;
+        const chip8::LockstepCpu& getCpu() const;
+
+        VecEnv(const VecEnv&) = delete;
+        VecEnv& operator=(const VecEnv&) = delete;
+
+      private:
+        void resetInstance(const size_t instance);
+        void readWatched(const size_t instance, const std::span<uint8_t> values) const;
+        std::span<uint8_t> getValues(std::vector<uint8_t>& values, const size_t instance) const;
+        chip8::env::StepResult getResult() const;
+
+      private:
+        const size_t instances;
+        const chip8::env::VecEnvOptions options;
+        chip8::LockstepCpu cpu;
+        chip8::LockstepCpu::LaneState startState;
+        uint64_t nextSeed;
+
+        // [instance * watched.size() + i]: value of watched location i.
+        std::vector<uint8_t> currentValues;
+        std::vector<uint8_t> previousValues;
+        std::vector<float> rewards;
+        std::vector<uint8_t> done;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include "aot/RomTranslator.hpp"
+
+#include <cpu/CompiledRom.hpp>
+#include <cpu/InstructionBinding.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <iomanip>
+#include <sstream>
+
+#include "../cpu/NativeInstructions.hpp"
+
+namespace
+{
+    std::string hex(const unsigned value, const int digits)
+    {
+        std::ostringstream stream;
+        stream << "0x" << std::hex << std::setw(digits) << std::setfill('0') << value;
+        return stream.str();
+    }
+
+    std::string label(const uint16_t address)
+    {
+        return "block_" + hex(address, 3).substr(2);
+    }
+
+    std::string V(const uint8_t index)
+    {
+        return "V[" + hex(index, 1) + "]";
+    }
+
+    bool isBranch(const uint8_t byte1)
+    {
+        switch (byte1 >> 4)
+        {
+        case 0x1:
+        case 0x3:
+        case 0x4:
+        case 0x5:
+        case 0x9:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+chip8::aot::RomTranslator::RomTranslator(const std::vector<uint8_t>& rom)
+    : rom(rom)
+{
+    if (rom.size() > MemorySize - ProgramStartLocation)
+    {
+        throw chip8::RomLoadFailureException("Not enough memory to execute the program");
+    }
+
+    findBlocks();
+}
+
+std::string chip8::aot::RomTranslator::translate(const std::string& romName) const
+{
+    std::ostringstream source;
+
+    source << "// Generated by chip8-aot from " << romName << ". Do not edit.\n";
+    source << "#include <cpu/CompiledRom.hpp>\n\n";
+    source << "namespace\n{\n";
+
+    source << "    constexpr std::array<uint8_t, " << rom.size() << "> image{";
+    for (size_t i = 0; i < rom.size(); i++)
+    {
+        source << (i % 12 == 0 ? "\n        " : " ") << hex(rom[i], 2) << (i + 1 < rom.size() ? "," : "\n    ");
+    }
+    source << "};\n\n";
+
+    if (blocks.empty())
+    {
+        source << "    void run(chip8::CompiledRom::State&)\n    {\n    }\n";
+    }
+    else
+    {
+        source << "    void run(chip8::CompiledRom::State& state)\n    {\n";
+        source << "        std::array<uint8_t, 16> V = state.V;\n";
+        source << "        uint16_t I = state.I;\n\n";
+        source << "        switch (state.PC)\n        {\n";
+        for (const auto& [start, length] : blocks)
+        {
+            source << "        case " << hex(start, 3) << ":\n            goto " << label(start) << ";\n";
+        }
+        source << "        default:\n            return;\n        }\n\n";
+
+        for (const auto& [start, length] : blocks)
+        {
+            source << translateBlock(start, length);
+        }
+
+        source << "    exit:\n";
+        source << "        state.V = V;\n";
+        source << "        state.I = I;\n";
+        source << "    }\n";
+    }
+
+    source << "}\n\n";
+    source << "const chip8::CompiledRom chip8_compiled_rom{image.data(), image.size(), &run};\n";
+
+    return source.str();
+}
+
+const std::map<uint16_t, size_t>& chip8::aot::RomTranslator::getBlocks() const
+{
+    return blocks;
+}
+
+bool chip8::aot::RomTranslator::isInRom(const size_t address) const
+{
+    return address >= ProgramStartLocation && address + 1 < ProgramStartLocation + rom.size();
+}
+
+bool chip8::aot::RomTranslator::isTranslatable(const uint16_t address) const
+{
+    return isInRom(address) &&
+           chip8::isNativeInstruction(rom[address - ProgramStartLocation], rom[address - ProgramStartLocation + 1], address);
+}
+
+// Addresses the instruction may continue at, when they are known statically.
+std::vector<uint16_t> chip8::aot::RomTranslator::getSuccessors(const uint16_t address) const
+{
+    const uint8_t byte1 = rom[address - ProgramStartLocation];
+    const uint8_t byte2 = rom[address - ProgramStartLocation + 1];
+    const uint16_t next = address + 2;
+
+    switch (byte1 >> 4)
+    {
+    case 0x0:
+        if (byte1 == 0x00 && byte2 == 0xE0)
+        {
+            return {next};
+        }
+        return {}; // Returns are followed through calls, sys throws
+    case 0x1:
+        return {binding::Operands::decode(byte1, byte2).nnn};
+    case 0x2:
+        return {binding::Operands::decode(byte1, byte2).nnn, next};
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+    case 0xE:
+        return {next, static_cast<uint16_t>(next + 2)};
+    case 0xB:
+        return {}; // Computed jump
+    default:
+        return {next};
+    }
+}
+
+std::set<uint16_t> chip8::aot::RomTranslator::findReachableAddresses() const
+{
+    std::set<uint16_t> reachable;
+    std::vector<uint16_t> pending{ProgramStartLocation};
+
+    while (!pending.empty())
+    {
+        const uint16_t address = pending.back();
+        pending.pop_back();
+
+        if (!isInRom(address) || !reachable.insert(address).second)
+        {
+            continue;
+        }
+
+        for (const uint16_t successor : getSuccessors(address))
+        {
+            pending.push_back(successor);
+        }
+    }
+
+    return reachable;
+}
+
+// Blocks start wherever execution may enter from elsewhere than the previous instruction: the program start, branch targets, and where
+// the interpreter stops after an instruction that is not translated.
+void chip8::aot::RomTranslator::findBlocks()
+{
+    std::vector<uint16_t> pending{ProgramStartLocation};
+
+    for (const uint16_t address : findReachableAddresses())
+    {
+        if (!isTranslatable(address) || isBranch(rom[address - ProgramStartLocation]))
+        {
+            const std::vector<uint16_t> successors = getSuccessors(address);
+            pending.insert(pending.end(), successors.begin(), successors.end());
+        }
+    }
+
+    while (!pending.empty())
+    {
+        const uint16_t start = pending.back();
+        pending.pop_back();
+
+        if (blocks.contains(start) || !isTranslatable(start))
+        {
+            continue;
+        }
+
+        size_t length = 0;
+        uint16_t address = start;
+        bool endsWithBranch = false;
+
+        while (length < CompiledRom::MaxBlockLength && isTranslatable(address))
+        {
+            length++;
+            if (isBranch(rom[address - ProgramStartLocation]))
+            {
+                endsWithBranch = true;
+                break;
+            }
+            address += 2;
+        }
+
+        blocks[start] = length;
+
+        // Blocks cut at the maximum length continue in another block.
+        if (!endsWithBranch && length == CompiledRom::MaxBlockLength)
+        {
+            pending.push_back(address);
+        }
+    }
+}
+
+std::string chip8::aot::RomTranslator::translateBlock(const uint16_t start, const size_t length) const
+{
+    std::ostringstream source;
+
+    source << "    " << label(start) << ":\n";
+    source << "        if (state.budget < " << length << " || state.modified[" << hex(start, 3) << "])\n        {\n";
+    source << "            state.PC = " << hex(start, 3) << ";\n";
+    source << "            goto exit;\n        }\n";
+    source << "        state.budget -= " << length << ";\n";
+
+    const uint16_t last = static_cast<uint16_t>(start + 2 * (length - 1));
+    for (uint16_t address = start; address < last; address += 2)
+    {
+        source << translateInstruction(address);
+    }
+
+    const uint8_t byte1 = rom[last - ProgramStartLocation];
+    const uint8_t byte2 = rom[last - ProgramStartLocation + 1];
+    const binding::Operands operands = binding::Operands::decode(byte1, byte2);
+    const uint16_t next = last + 2;
+
+    if (!isBranch(byte1))
+    {
+        source << translateInstruction(last);
+        source << translateExit(next);
+        return source.str();
+    }
+
+    source << "        // " << hex(last, 3) << ": " << hex((byte1 << 8) | byte2, 4).substr(2) << "\n";
+
+    switch (byte1 >> 4)
+    {
+    case 0x1:
+        source << translateExit(operands.nnn);
+        return source.str();
+    case 0x3:
+        source << "        if (" << V(operands.x) << " == " << hex(operands.kk, 2) << ")\n";
+        break;
+    case 0x4:
+        source << "        if (" << V(operands.x) << " != " << hex(operands.kk, 2) << ")\n";
+        break;
+    case 0x5:
+        source << "        if (" << V(operands.x) << " == " << V(operands.y) << ")\n";
+        break;
+    case 0x9:
+        source << "        if (" << V(operands.x) << " != " << V(operands.y) << ")\n";
+        break;
+    }
+
+    source << "        {\n";
+    std::istringstream skip(translateExit(next + 2));
+    for (std::string line; std::getline(skip, line);)
+    {
+        source << "    " << line << "\n";
+    }
+    source << "        }\n";
+    source << translateExit(next);
+
+    return source.str();
+}
+
+// Writes Vx and VF in the order of the interpreter (see execute_add_vx_vy in Cpu.cpp), one statement per write on the same variables,
+// so that the generated code needs nothing else when Vx or Vy is VF.
+std::string chip8::aot::RomTranslator::translateInstruction(const uint16_t address) const
+{
+    const uint8_t byte1 = rom[address - ProgramStartLocation];
+    const uint8_t byte2 = rom[address - ProgramStartLocation + 1];
+    const binding::Operands operands = binding::Operands::decode(byte1, byte2);
+    const std::string x = V(operands.x);
+    const std::string y = V(operands.y);
+    const std::string f = V(0xF);
+
+    std::ostringstream source;
+    source << "        // " << hex(address, 3) << ": " << hex((byte1 << 8) | byte2, 4).substr(2) << "\n";
+
+    switch (byte1 >> 4)
+    {
+    case 0x6:
+        source << "        " << x << " = " << hex(operands.kk, 2) << ";\n";
+        break;
+    case 0x7:
+        source << "        " << x << " = static_cast<uint8_t>(" << x << " + " << hex(operands.kk, 2) << ");\n";
+        break;
+    case 0xA:
+        source << "        I = " << hex(operands.nnn, 3) << ";\n";
+        break;
+    case 0x8:
+        switch (operands.n)
+        {
+        case 0x0:
+            source << "        " << x << " = " << y << ";\n";
+            break;
+        case 0x1:
+            source << "        " << x << " |= " << y << ";\n";
+            break;
+        case 0x2:
+            source << "        " << x << " &= " << y << ";\n";
+            break;
+        case 0x3:
+            source << "        " << x << " ^= " << y << ";\n";
+            break;
+        case 0x4:
+            source << "        {\n";
+            source << "            const uint8_t original = " << x << ";\n";
+            source << "            " << x << " = static_cast<uint8_t>(" << x << " + " << y << ");\n";
+            source << "            " << f << " = " << x << " < original;\n";
+            source << "        }\n";
+            break;
+        case 0x5:
+            source << "        {\n";
+            source << "            const uint8_t original = " << x << ";\n";
+            source << "            " << x << " = static_cast<uint8_t>(" << x << " - " << y << ");\n";
+            source << "            " << f << " = " << x << " <= original;\n";
+            source << "        }\n";
+            break;
+        case 0x6:
+            source << "        " << f << " = " << x << " & 1;\n";
+            source << "        " << x << " = " << x << " >> 1;\n";
+            break;
+        case 0x7:
+            source << "        {\n";
+            source << "            const uint8_t original = " << y << ";\n";
+            source << "            " << x << " = static_cast<uint8_t>(" << y << " - " << x << ");\n";
+            source << "            " << f << " = " << x << " <= original;\n";
+            source << "        }\n";
+            break;
+        case 0xE:
+            source << "        " << f << " = (" << x << " & 0x80) == 0x80;\n";
+            source << "        " << x << " = static_cast<uint8_t>(" << x << " << 1);\n";
+            break;
+        }
+        break;
+    case 0xF:
+        source << "        " << x << " = state.delayTimer;\n";
+        break;
+    }
+
+    return source.str();
+}
+
+std::string chip8::aot::RomTranslator::translateExit(const uint16_t target) const
+{
+    if (blocks.contains(target))
+    {
+        return "        goto " + label(target) + ";\n";
+    }
+
+    return "        state.PC = " + hex(target, 3) + ";\n        goto exit;\n";
+}
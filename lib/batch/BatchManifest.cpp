@@ -0,0 +1,56 @@
+#include "batch/BatchManifest.hpp"
+
+#include <batch/ManifestException.hpp>
+#include <cctype>
+#include <sstream>
+#include <string>
+
+std::vector<chip8::batch::BatchJob> chip8::batch::readManifest(std::istream& manifest, const std::filesystem::path& directory)
+{
+    std::vector<chip8::batch::BatchJob> jobs;
+    std::string line;
+
+    for (size_t lineNumber = 1; std::getline(manifest, line); lineNumber++)
+    {
+        std::istringstream fields(line);
+        std::string rom;
+        if (!(fields >> rom) || rom[0] == '#')
+        {
+            continue;
+        }
+
+        std::string seed;
+        std::string inputScript;
+        std::string instructions;
+        std::string extra;
+        BatchJob job{directory / rom, 0, {}, 0};
+
+        // Numbers must start with a digit: unsigned extraction would accept a minus sign.
+        const auto parseNumber = [](const std::string& field, uint64_t& value) {
+            std::istringstream stream(field);
+            return std::isdigit(static_cast<unsigned char>(field[0])) && stream >> value && stream.eof();
+        };
+
+        if (!(fields >> seed >> inputScript >> instructions) || fields >> extra || !parseNumber(seed, job.seed) ||
+            !parseNumber(instructions, job.instructions))
+        {
+            throw chip8::batch::ManifestException("line " + std::to_string(lineNumber) +
+                                                  ": expected <rom> <seed> <input script> <instructions>, got \"" + line + "\"");
+        }
+
+        // Headless runs have no frame limit, so a job without instruction limit would never end unless its ROM waits for a key.
+        if (job.instructions == 0)
+        {
+            throw chip8::batch::ManifestException("line " + std::to_string(lineNumber) + ": the number of instructions must not be 0");
+        }
+
+        if (inputScript != "-")
+        {
+            job.inputScript = directory / inputScript;
+        }
+
+        jobs.push_back(std::move(job));
+    }
+
+    return jobs;
+}
\ No newline at end of file
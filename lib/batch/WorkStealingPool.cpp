@@ -0,0 +1,142 @@
+#include "batch/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+chip8::batch::WorkStealingPool::WorkStealingPool(const size_t threads)
+    : threads(threads != 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency()))
+    , ranges(this->threads)
+    , failed(false)
+{
+}
+
+size_t chip8::batch::WorkStealingPool::getThreadCount() const
+{
+    return threads;
+}
+
+void chip8::batch::WorkStealingPool::run(const size_t jobs, const std::function<void(size_t job, size_t worker)>& task)
+{
+    if (jobs > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::length_error("Too many jobs");
+    }
+
+    for (size_t worker = 0; worker < threads; worker++)
+    {
+        ranges[worker].jobs = pack(static_cast<uint32_t>(jobs * worker / threads), static_cast<uint32_t>(jobs * (worker + 1) / threads));
+    }
+    failed = false;
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    const std::function<void(size_t job, size_t worker)> guardedTask = [&](const size_t job, const size_t worker) {
+        try
+        {
+            task(job, worker);
+        }
+        catch (...)
+        {
+            const std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            failed = true;
+        }
+    };
+
+    // The calling thread is the last worker.
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker + 1 < threads; worker++)
+    {
+        workers.emplace_back(&WorkStealingPool::work, this, worker, std::cref(guardedTask));
+    }
+    work(threads - 1, guardedTask);
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+uint64_t chip8::batch::WorkStealingPool::pack(const uint32_t begin, const uint32_t end)
+{
+    return static_cast<uint64_t>(end) << 32 | begin;
+}
+
+bool chip8::batch::WorkStealingPool::takeJob(const size_t worker, uint32_t& job)
+{
+    uint64_t jobs = ranges[worker].jobs.load();
+    do
+    {
+        const uint32_t begin = static_cast<uint32_t>(jobs);
+        const uint32_t end = static_cast<uint32_t>(jobs >> 32);
+        if (begin == end)
+        {
+            return false;
+        }
+
+        job = begin;
+    } while (!ranges[worker].jobs.compare_exchange_weak(jobs, pack(job + 1, static_cast<uint32_t>(jobs >> 32))));
+
+    return true;
+}
+
+// Moves the back half of the largest range of the other workers into the (empty) range of worker. Returns false once there is nothing
+// left to steal.
+bool chip8::batch::WorkStealingPool::steal(const size_t worker)
+{
+    while (true)
+    {
+        size_t victim = worker;
+        uint64_t victimJobs = 0;
+        uint32_t largest = 0;
+
+        for (size_t other = 0; other < threads; other++)
+        {
+            const uint64_t jobs = ranges[other].jobs.load();
+            const uint32_t size = static_cast<uint32_t>(jobs >> 32) - static_cast<uint32_t>(jobs);
+            if (other != worker && size > largest)
+            {
+                victim = other;
+                victimJobs = jobs;
+                largest = size;
+            }
+        }
+
+        if (largest == 0)
+        {
+            return false;
+        }
+
+        // A single job left is taken as well: its owner may be busy with a long one.
+        const uint32_t begin = static_cast<uint32_t>(victimJobs);
+        const uint32_t end = static_cast<uint32_t>(victimJobs >> 32);
+        const uint32_t middle = end - (largest + 1) / 2;
+        if (ranges[victim].jobs.compare_exchange_strong(victimJobs, pack(begin, middle)))
+        {
+            // Only this thread adds jobs to its own range: thieves skip it while it is empty.
+            ranges[worker].jobs = pack(middle, end);
+            return true;
+        }
+    }
+}
+
+void chip8::batch::WorkStealingPool::work(const size_t worker, const std::function<void(size_t job, size_t worker)>& task)
+{
+    uint32_t job = 0;
+    while (!failed && (takeJob(worker, job) || (steal(worker) && takeJob(worker, job))))
+    {
+        task(job, worker);
+    }
+}
\ No newline at end of file
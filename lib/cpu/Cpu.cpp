@@ -1,67 +1,76 @@
 #include "cpu/Cpu.hpp"
 
+#include <algorithm>
 #include <cpu/CpuExecutionException.hpp>
 #include <cpu/Font.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
 #include <cpu/RomLoadFailureException.hpp>
+#include <cpu/Timer.hpp>
 #include <functional>
+#include <stdexcept>
 
-chip8::Cpu::Cpu(const logging::Logger& logger, chip8::IGpu& gpu, chip8::ITimer& soundTimer, chip8::ITimer& delayTimer)
+#include "JitCompiler.hpp"
+
+static_assert(sizeof(chip8::Cpu) < 5 * 1024, "Cpu instances should not be larger than the machine they emulate (plus registers and stack)");
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::BasicCpu(const logging::Logger& logger,
+                                                            GpuType& gpu,
+                                                            TimerType& soundTimer,
+                                                            TimerType& delayTimer,
+                                                            const chip8::ExecutionEngine engine,
+                                                            chip8::RandomGenerator randomGenerator)
     : logger(logger)
     , gpu(gpu)
-    , memory()
     , soundTimer(soundTimer)
     , delayTimer(delayTimer)
-    , randomDevice()
-    , randomEngine(randomDevice())
+    , registers()
+    , memory()
+    , randomGenerator(std::move(randomGenerator))
     , playAudioFlag(false)
-    , uniformDistrubution(std::numeric_limits<uint8_t>::min(), std::numeric_limits<uint8_t>::max())
-    , registers(std::bind(&Cpu::validateMemoryWrite, this, std::placeholders::_1),
-                std::bind(&Cpu::validateMemoryRead, this, std::placeholders::_1),
-                std::bind(&Cpu::validateStackWrite, this, std::placeholders::_1),
-                std::bind(&Cpu::validateStackRead, this, std::placeholders::_1))
-    , instructions(std::bind(&chip8::Cpu::execute_sys_addr, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_cls, this),
-                   std::bind(&chip8::Cpu::execute_ret, this),
-                   std::bind(&chip8::Cpu::execute_jp_addr, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_call_addr, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_se_vx_byte, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_sne_vx_byte, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_se_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_ld_vx_byte, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_add_vx_byte, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_ld_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_or_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_and_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_xor_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_add_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_sub_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_shr_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_subn_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_shl_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_sne_vx_vy, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_ld_i_addr, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_jp_v0_addr, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_rnd_vx_byte, this, std::placeholders::_1, std::placeholders::_2),
-                   std::bind(&chip8::Cpu::execute_drw_vx_vy_nibble, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-                   std::bind(&chip8::Cpu::execute_skp_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_sknp_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_vx_dt, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_vx_k, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_dt_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_st_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_add_i_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_f_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_b_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_idata_vx, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::execute_ld_vx_idata, this, std::placeholders::_1),
-                   std::bind(&chip8::Cpu::onUnmatchedInstruction, this))
-{
-}
-
-void chip8::Cpu::boot(std::istream& stream)
+    , frameDirty(false)
+    , state(CpuState::Running)
+    , displayMode(DisplayMode::Coalesced)
+    , engine(engine == ExecutionEngine::Jit && !JitCompiler::isSupported() ? ExecutionEngine::BasicBlock : engine)
+    , decodedInstructions(this->engine != ExecutionEngine::Interpreter ? MemorySize : 0)
+    , basicBlockLengths(this->engine == ExecutionEngine::BasicBlock ? MemorySize : 0)
+    , jitCompiler(this->engine == ExecutionEngine::Jit ? std::make_unique<JitCompiler>(memory.data(), MemorySize) : nullptr)
+    , compiledRom(nullptr)
+    , compiledRomLoaded(false)
+{
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::~BasicCpu() = default;
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::setCompiledRom(const chip8::CompiledRom* compiledRom)
+{
+    this->compiledRom = compiledRom;
+    compiledRomLoaded = false;
+    modifiedMemory.assign(compiledRom != nullptr ? MemorySize : 0, 0);
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::setDisplayMode(const chip8::DisplayMode displayMode)
+{
+    this->displayMode = displayMode;
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::setRandomGenerator(chip8::RandomGenerator randomGenerator)
+{
+    this->randomGenerator = std::move(randomGenerator);
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::boot(std::istream& stream)
 {
     initializeRegisters();
     initializeMemory();
+    playAudioFlag = false;
+    state = CpuState::Running;
 
     stream.seekg(0, std::ios::end);
     const size_t streamLength = stream.tellg();
@@ -74,70 +83,216 @@ void chip8::Cpu::boot(std::istream& stream)
     stream.seekg(0, std::ios::beg);
     stream.read(reinterpret_cast<char*>(memory.data() + ProgramStartLocation), streamLength);
     std::copy(chip8::font.begin(), chip8::font.end(), memory.begin());
+    invalidateDecodedInstructions(0, MemorySize);
+
+    if (compiledRom != nullptr)
+    {
+        compiledRomLoaded = compiledRom->imageSize == streamLength &&
+                            std::equal(compiledRom->image, compiledRom->image + streamLength, memory.begin() + ProgramStartLocation);
+        std::fill(modifiedMemory.begin(), modifiedMemory.end(), 0);
+
+        if (!compiledRomLoaded)
+        {
+            logger.logWarning("The compiled ROM was not translated from the booted ROM: interpreting it instead");
+        }
+    }
 
     registers.PC = static_cast<uint16_t>(ProgramStartLocation);
 }
 
-void chip8::Cpu::runClockCycle()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runClockCycle()
 {
-    uint8_t byte1 = memory[*registers.PC];
-    uint8_t byte2 = memory[registers.PC + 1];
-    registers.PC += 2;
+    run(1);
+}
 
-    delayTimer.updateValue();
-    soundTimer.updateValue();
-    playAudioFlag = soundTimer.getValue() > 0;
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+chip8::RunResult chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::run(const size_t maxInstructions)
+{
+    const bool playedAudio = playAudioFlag;
+    size_t executedInstructions = 0;
+    frameDirty = false;
 
-    state = CpuState::Running;
-    instructions.matchInstruction(byte1, byte2);
+    while (executedInstructions < maxInstructions)
+    {
+        const size_t remainingInstructions = maxInstructions - executedInstructions;
+        size_t blockInstructions = runCompiledRom(remainingInstructions);
+
+        if (blockInstructions == 0 && engine == ExecutionEngine::BasicBlock)
+        {
+            blockInstructions = runBasicBlock(remainingInstructions);
+        }
+        else if (blockInstructions == 0 && engine == ExecutionEngine::Jit)
+        {
+            blockInstructions = runCompiledCode(remainingInstructions);
+        }
+        else if (blockInstructions == 0 && engine == ExecutionEngine::Threaded)
+        {
+            blockInstructions = runThreaded(remainingInstructions);
+        }
+
+        // No block fits in the remaining budget, or the engine does not run blocks: execute a single instruction.
+        if (blockInstructions == 0)
+        {
+            step();
+            blockInstructions = 1;
+        }
+
+        executedInstructions += blockInstructions;
+
+        if (isWaiting())
+        {
+            break;
+        }
+    }
+
+    StopReason stopReason = StopReason::BudgetExhausted;
+    if (isWaiting())
+    {
+        stopReason = state == CpuState::WaitForKey ? StopReason::WaitForKey : StopReason::WaitForDraw;
+    }
+
+    return {executedInstructions, stopReason, playAudioFlag != playedAudio, frameDirty};
 }
 
-void chip8::Cpu::onKeyPressed(const chip8::Key key)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::onKeyPressed(const chip8::Key key)
 {
     keyPressedStatus[static_cast<size_t>(key)] = true;
 }
 
-void chip8::Cpu::onKeyReleased(const chip8::Key key)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::onKeyReleased(const chip8::Key key)
 {
     keyPressedStatus[static_cast<size_t>(key)] = false;
 }
 
-bool chip8::Cpu::shouldPlayAudio() const
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+bool chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::shouldPlayAudio() const
 {
     return playAudioFlag;
 }
 
-chip8::CpuState chip8::Cpu::getCpuState() const
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+chip8::CpuState chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getCpuState() const
 {
     return state;
 }
 
-void chip8::Cpu::onDrawComplete()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::onDrawComplete()
 {
+    gpu.onDrawComplete();
     state = CpuState::Running;
 }
 
-size_t chip8::Cpu::getWidth() const
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getWidth() const
 {
     return gpu.getWidth();
 }
 
-size_t chip8::Cpu::getHeight() const
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getHeight() const
 {
     return gpu.getHeight();
 }
 
-const std::vector<bool>& chip8::Cpu::getFrameBuffer() const
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+std::span<const uint64_t> chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getFrameBuffer() const
 {
     return gpu.getFrameBuffer();
 }
 
-chip8::Registers& chip8::Cpu::getRegisters()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+uint32_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getDirtyRows() const
+{
+    return gpu.getDirtyRows();
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+typename chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::Registers& chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getRegisters()
 {
     return registers;
 }
 
-void chip8::Cpu::initializeRegisters()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+chip8::CpuSnapshot chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::save() const
+{
+    chip8::CpuSnapshot snapshot{};
+    snapshot.randomState = randomGenerator.getState();
+
+    const std::span<const uint64_t> frameBuffer = gpu.getFrameBuffer();
+    std::copy_n(frameBuffer.begin(), std::min(frameBuffer.size(), snapshot.frameBuffer.size()), snapshot.frameBuffer.begin());
+    snapshot.memory = memory;
+    snapshot.stack = stack;
+    snapshot.V = registers.V;
+    snapshot.I = *registers.I;
+    snapshot.PC = *registers.PC;
+    snapshot.SP = *registers.SP;
+
+    for (size_t key = 0; key < keyPressedStatus.size(); key++)
+    {
+        snapshot.keys |= static_cast<uint16_t>(keyPressedStatus[key] << key);
+    }
+
+    snapshot.delayTimer = delayTimer.getValue();
+    snapshot.soundTimer = soundTimer.getValue();
+    snapshot.playAudio = playAudioFlag;
+    snapshot.state = static_cast<uint8_t>(state);
+    return snapshot;
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::restore(const chip8::CpuSnapshot& snapshot)
+{
+    // Checked before anything changes, so that a failed restore leaves the machine as it was.
+    if (snapshot.I > MemorySize || snapshot.PC > MemorySize || snapshot.SP > StackSize ||
+        snapshot.state > static_cast<uint8_t>(CpuState::WaitForKey))
+    {
+        throw std::invalid_argument("Snapshot registers out of bounds");
+    }
+
+    // First, for the same reason: only some generators can be restored.
+    randomGenerator.setState(snapshot.randomState);
+
+    for (size_t address = 0; address < MemorySize;)
+    {
+        const size_t first = std::mismatch(memory.begin() + address, memory.end(), snapshot.memory.begin() + address).first - memory.begin();
+        size_t last = first;
+        while (last < MemorySize && memory[last] != snapshot.memory[last])
+        {
+            last++;
+        }
+
+        if (last > first)
+        {
+            invalidateDecodedInstructions(static_cast<uint16_t>(first), last - first);
+        }
+        address = last;
+    }
+
+    memory = snapshot.memory;
+    stack = snapshot.stack;
+    registers.V = snapshot.V;
+    registers.I = snapshot.I;
+    registers.PC = snapshot.PC;
+    registers.SP = snapshot.SP;
+
+    for (size_t key = 0; key < keyPressedStatus.size(); key++)
+    {
+        keyPressedStatus[key] = (snapshot.keys >> key & 1) != 0;
+    }
+
+    delayTimer.setValue(snapshot.delayTimer);
+    soundTimer.setValue(snapshot.soundTimer);
+    playAudioFlag = snapshot.playAudio != 0;
+    state = static_cast<CpuState>(snapshot.state);
+    gpu.setFrameBuffer(snapshot.frameBuffer);
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::initializeRegisters()
 {
     registers.I = 0;
     registers.PC = 0;
@@ -145,61 +300,442 @@ void chip8::Cpu::initializeRegisters()
     std::fill(registers.V.begin(), registers.V.end(), 0);
 }
 
-void chip8::Cpu::initializeMemory()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::initializeMemory()
 {
     std::fill(memory.begin(), memory.end(), 0);
     std::fill(stack.begin(), stack.end(), 0);
     std::fill(keyPressedStatus.begin(), keyPressedStatus.end(), false);
 }
 
-// The validators below allow accessing one extra byte going out of memory.
-// This is necessary when for example the stack is full (stack pointer will point to 65-th byte, because it points to the next
-// elment to be pushed). However, validation should fail when writing to 65-th byte but it does not.
-// Maybe have separate read and write validators.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+typename chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::DecodedInstruction
+chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::fetchInstruction()
+{
+    // Read the second byte first: validating its address also guarantees the first one is within memory.
+    const uint8_t byte2 = memory[registers.PC + 1];
+    const uint8_t byte1 = memory[*registers.PC];
+    return InstructionSet::getInstance().decode(byte1, byte2);
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+typename chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::DecodedInstruction
+chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::fetchDecodedInstruction()
+{
+    if (*registers.PC >= decodedInstructions.size())
+    {
+        return fetchInstruction(); // Reports the invalid address
+    }
+
+    DecodedInstruction& instruction = decodedInstructions[*registers.PC];
+
+    // Decode on first execution. Addresses are validated only then: a decoded instruction is always within memory.
+    if (instruction.callback == nullptr)
+    {
+        instruction = fetchInstruction();
+
+        if (engine == ExecutionEngine::Threaded)
+        {
+            instruction.index = findSuperinstruction(*registers.PC, instruction.index);
+        }
+    }
+
+    // Return a copy: executing the instruction may invalidate its cache entry (self-modifying code).
+    return instruction;
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::invalidateDecodedInstructions(uint16_t address, size_t length)
+{
+    // Stores wrapping around the end of memory (see WrappedBounds) continue at address 0.
+    if (static_cast<size_t>(address) + length > MemorySize)
+    {
+        invalidateDecodedInstructions(0, address + length - MemorySize);
+    }
+
+    if (jitCompiler != nullptr)
+    {
+        jitCompiler->invalidate(address, length);
+    }
+
+    if (compiledRomLoaded)
+    {
+        // Translated blocks that may contain the written bytes.
+        const size_t firstBlock = address >= 2 * CompiledRom::MaxBlockLength ? address - 2 * CompiledRom::MaxBlockLength + 1 : 0;
+        const size_t lastBlock = std::min(static_cast<size_t>(address) + length, MemorySize);
+        std::fill(modifiedMemory.begin() + firstBlock, modifiedMemory.begin() + lastBlock, 1);
+    }
+
+    if (decodedInstructions.empty())
+    {
+        return;
+    }
+
+    // Instructions are two bytes long, so the one starting right before the written bytes is affected as well.
+    const size_t first = address > 0 ? address - 1 : 0;
+    const size_t last = std::min(static_cast<size_t>(address) + length, MemorySize);
+    std::fill(decodedInstructions.begin() + first, decodedInstructions.begin() + last, DecodedInstruction{});
+
+    if (!basicBlockLengths.empty())
+    {
+        // So are all the basic blocks that may contain those instructions.
+        const size_t firstBasicBlock = first > 2 * MaxBasicBlockLength ? first - 2 * MaxBasicBlockLength : 0;
+        std::fill(basicBlockLengths.begin() + firstBasicBlock, basicBlockLengths.begin() + last, 0);
+    }
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::step()
+{
+    const DecodedInstruction instruction = startInstruction();
+    instruction.callback(*this, instruction.operands);
+}
+
+// Fetches the instruction at PC and updates everything that precedes its execution.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+typename chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::DecodedInstruction
+chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::startInstruction()
+{
+    const DecodedInstruction instruction = engine != ExecutionEngine::Interpreter ? fetchDecodedInstruction() : fetchInstruction();
+    registers.PC += 2;
 
-void chip8::Cpu::validateMemoryWrite(uint16_t address)
+    delayTimer.updateValue();
+    soundTimer.updateValue();
+    playAudioFlag = soundTimer.getValue() > 0;
+
+    state = CpuState::Running;
+    return instruction;
+}
+
+// Whether running further must wait: for a key press, or for the next frame after a draw in DisplayMode::DisplayWait.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+bool chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::isWaiting() const
+{
+    return state == CpuState::WaitForKey || (state == CpuState::WaitForDraw && displayMode == DisplayMode::DisplayWait);
+}
+
+// A basic block is a sequence of instructions executed one after the other: it ends with the first instruction that is not sequential (see
+// binding::InstructionKind). Memory stores end blocks as well, so that a block never executes instructions it may have overwritten.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::getBasicBlockLength()
 {
-    if (address > MemorySize)
+    const uint16_t start = *registers.PC;
+
+    if (static_cast<size_t>(start) + 1 >= MemorySize)
     {
-        throw CpuExecutionException(CpuErrorCode::AddressOutOfBound);
+        return 0; // Let step report the invalid address
     }
+
+    if (basicBlockLengths[start] == 0)
+    {
+        const InstructionSet& instructionSet = InstructionSet::getInstance();
+        size_t length = 0;
+
+        for (size_t address = start; address + 1 < MemorySize && length < MaxBasicBlockLength; address += 2)
+        {
+            if (decodedInstructions[address].callback == nullptr)
+            {
+                decodedInstructions[address] = instructionSet.decode(memory[address], memory[address + 1]);
+            }
+
+            length++;
+
+            if (instructionSet.getKind(memory[address], memory[address + 1]) != binding::InstructionKind::Sequential)
+            {
+                break;
+            }
+        }
+
+        basicBlockLengths[start] = static_cast<uint8_t>(length);
+    }
+
+    return basicBlockLengths[start];
 }
 
-void chip8::Cpu::validateStackWrite(uint8_t address)
+// Timers, audio and CPU state are updated once per block rather than once per instruction: no instruction but the last one may wait
+// for a draw or a key press. Blocks are executed entirely or not at all: returns 0 if the block is longer than maxInstructions.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runBasicBlock(const size_t maxInstructions)
 {
-    if (address > StackSize)
+    const size_t length = getBasicBlockLength();
+    if (length == 0 || length > maxInstructions)
+    {
+        return 0;
+    }
+
+    delayTimer.updateValue();
+    soundTimer.updateValue();
+    playAudioFlag = soundTimer.getValue() > 0;
+
+    state = CpuState::Running;
+
+    const uint16_t start = *registers.PC;
+    for (size_t i = 0; i < length; i++)
     {
-        throw CpuExecutionException(CpuErrorCode::StackOverflow);
+        const DecodedInstruction instruction = decodedInstructions[start + 2 * i];
+        registers.PC += 2;
+        instruction.callback(*this, instruction.operands);
     }
+
+    return length;
 }
 
-void chip8::Cpu::validateMemoryRead(uint16_t address)
+// One handler per instruction of BasicInstructionSet<Cpu>, in index order (see BasicInstructionSet::getNumberOfInstructions).
+#define CHIP8_FOR_EACH_INSTRUCTION(F)                                                                                                      \
+    F(0) F(1) F(2) F(3) F(4) F(5) F(6) F(7) F(8) F(9) F(10) F(11) F(12) F(13) F(14) F(15) F(16) F(17) F(18) F(19) F(20) F(21) F(22) F(23)  \
+        F(24) F(25) F(26) F(27) F(28) F(29) F(30) F(31) F(32) F(33) F(34) F(35)
+
+// Superinstructions: pairs of instructions often executed from consecutive addresses, numbered after the instructions. They are the pairs
+// among the 24 most frequent ones of "chip8-benchmark ../../roms --profile" (the default 100,000,000 instructions on each of the 19 ROMs,
+// 1,900,000,000 in total), in order, leaving out those starting with DRW or LD Vx, K: waiting ends the run anyway.
+#define CHIP8_FOR_EACH_SUPERINSTRUCTION(F)                                                                                                 \
+    F(36, 0x3000, 0x1000) /* SE Vx, byte; JP addr */                                                                                       \
+    F(37, 0xF007, 0x3000) /* LD Vx, DT; SE Vx, byte (delay loop) */                                                                        \
+    F(38, 0xA000, 0xD000) /* LD I, addr; DRW Vx, Vy, nibble */                                                                             \
+    F(39, 0xF029, 0xD000) /* LD F, Vx; DRW Vx, Vy, nibble */                                                                               \
+    F(40, 0x6000, 0xA000) /* LD Vx, byte; LD I, addr */                                                                                    \
+    F(41, 0x8000, 0x8000) /* LD Vx, Vy; LD Vx, Vy */                                                                                       \
+    F(42, 0x7000, 0x3000) /* ADD Vx, byte; SE Vx, byte */                                                                                  \
+    F(43, 0x6000, 0x6000) /* LD Vx, byte; LD Vx, byte */                                                                                   \
+    F(44, 0xE09E, 0x1000) /* SKP Vx; JP addr */                                                                                            \
+    F(45, 0xA000, 0xF01E) /* LD I, addr; ADD I, Vx */                                                                                      \
+    F(46, 0xA000, 0x6000) /* LD I, addr; LD Vx, byte */                                                                                    \
+    F(47, 0x6000, 0xF00A) /* LD Vx, byte; LD Vx, K */                                                                                      \
+    F(48, 0xF018, 0xF029) /* LD ST, Vx; LD F, Vx */                                                                                        \
+    F(49, 0x00E0, 0xF018) /* CLS; LD ST, Vx */                                                                                             \
+    F(50, 0x7000, 0x7000) /* ADD Vx, byte; ADD Vx, byte */                                                                                 \
+    F(51, 0xF01E, 0xF065) /* ADD I, Vx; LD Vx, [I] */                                                                                      \
+    F(52, 0x7000, 0x1000) /* ADD Vx, byte; JP addr */                                                                                      \
+    F(53, 0x8000, 0x3000) /* LD Vx, Vy; SE Vx, byte */
+
+#define CHIP8_EXECUTE_INSTRUCTION(number)                                                                                                  \
+    {                                                                                                                                      \
+        constexpr typename InstructionSet::Callback callback = InstructionSet::template getCallback<number>();                             \
+        callback(*this, instruction.operands);                                                                                             \
+    }
+
+#define CHIP8_FETCH_NEXT_INSTRUCTION()                                                                                                     \
+    if (executedInstructions == maxInstructions || isWaiting())                                                                            \
+    {                                                                                                                                      \
+        return executedInstructions;                                                                                                       \
+    }                                                                                                                                      \
+    instruction = startInstruction();                                                                                                      \
+    executedInstructions++;
+
+namespace
 {
-    if (address >= MemorySize)
+    constexpr size_t NumberOfInstructions = chip8::BasicInstructionSet<chip8::Cpu>::getNumberOfInstructions();
+
+    struct Superinstruction
     {
-        throw CpuExecutionException(CpuErrorCode::AddressOutOfBound);
+        uint8_t index;
+        uint16_t first;
+        uint16_t second;
+    };
+
+#define CHIP8_SUPERINSTRUCTION(number, first, second) {number, first, second},
+    constexpr Superinstruction Superinstructions[] = {CHIP8_FOR_EACH_SUPERINSTRUCTION(CHIP8_SUPERINSTRUCTION)};
+#undef CHIP8_SUPERINSTRUCTION
+
+    // Handlers are looked up by index: superinstructions must be numbered in order.
+    constexpr bool areSuperinstructionsNumbered()
+    {
+        for (size_t i = 0; i < std::size(Superinstructions); i++)
+        {
+            if (Superinstructions[i].index != NumberOfInstructions + i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(areSuperinstructionsNumbered(), "Superinstructions must be numbered from NumberOfInstructions on");
+
+    // Instruction index x instruction index -> superinstruction index, or 0 if the pair is not fused.
+    constexpr auto SuperinstructionTable = [] {
+        std::array<std::array<uint8_t, NumberOfInstructions>, NumberOfInstructions> table{};
+        for (const Superinstruction& superinstruction : Superinstructions)
+        {
+            const uint8_t first = chip8::BasicInstructionSet<chip8::Cpu>::getIndex(superinstruction.first);
+            const uint8_t second = chip8::BasicInstructionSet<chip8::Cpu>::getIndex(superinstruction.second);
+            table[first][second] = superinstruction.index;
+        }
+        return table;
+    }();
+}
+
+// Returns the index of the superinstruction made of the given instruction and the one following it in memory, if any.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+uint8_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::findSuperinstruction(const uint16_t address, const uint8_t index) const
+{
+    if (static_cast<size_t>(address) + 3 >= MemorySize)
+    {
+        return index;
     }
+
+    const uint8_t nextIndex = InstructionSet::getInstance().decode(memory[address + 2], memory[address + 3]).index;
+    const uint8_t superinstruction = SuperinstructionTable[index][nextIndex];
+    return superinstruction != 0 ? superinstruction : index;
 }
 
-void chip8::Cpu::validateStackRead(uint8_t address)
+// Define CHIP8_NO_COMPUTED_GOTO to build the switch used by other compilers instead (see chip8-switch-test).
+#if defined(__GNUC__) && !defined(CHIP8_NO_COMPUTED_GOTO)
+#define CHIP8_COMPUTED_GOTO
+#endif
+
+// Executes instructions one at a time like the interpreters, but without returning to Cpu::run in between: each instruction is executed
+// by a handler calling its callback directly, which then fetches and dispatches the next instruction itself. With computed goto (GCC,
+// Clang) every handler has its own indirect jump, which the branch predictor can correlate with the instruction being executed.
+//
+// Superinstruction handlers execute their first instruction, then the second one without dispatching if it is the next instruction:
+// their index is only a hint (see findSuperinstruction), the instruction fetched after the first one is checked before being executed.
+//
+// Runs until maxInstructions instructions have been executed or the CPU waits for a key press.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runThreaded(const size_t maxInstructions)
 {
-    if (address >= StackSize)
+    static_assert(NumberOfInstructions == 36, "Every instruction needs a handler");
+
+    size_t executedInstructions = 1;
+    DecodedInstruction instruction = startInstruction();
+
+#ifdef CHIP8_COMPUTED_GOTO
+#define CHIP8_HANDLER_ADDRESS(number) &&execute_##number,
+#define CHIP8_SUPERINSTRUCTION_HANDLER_ADDRESS(number, first, second) &&execute_##number,
+#define CHIP8_HANDLER(number)                                                                                                              \
+    execute_##number:                                                                                                                      \
+    CHIP8_EXECUTE_INSTRUCTION(number)                                                                                                      \
+    CHIP8_FETCH_NEXT_INSTRUCTION()                                                                                                         \
+    goto* handlers[instruction.index];
+#define CHIP8_SUPERINSTRUCTION_HANDLER(number, first, second)                                                                              \
+    execute_##number:                                                                                                                      \
+    CHIP8_EXECUTE_INSTRUCTION(InstructionSet::getIndex(first))                                                                             \
+    CHIP8_FETCH_NEXT_INSTRUCTION()                                                                                                         \
+    if (instruction.callback != InstructionSet::template getCallback<InstructionSet::getIndex(second)>())                                  \
+    {                                                                                                                                      \
+        goto* handlers[instruction.index];                                                                                                 \
+    }                                                                                                                                      \
+    CHIP8_EXECUTE_INSTRUCTION(InstructionSet::getIndex(second))                                                                            \
+    CHIP8_FETCH_NEXT_INSTRUCTION()                                                                                                         \
+    goto* handlers[instruction.index];
+
+    static void* const handlers[] = {CHIP8_FOR_EACH_INSTRUCTION(CHIP8_HANDLER_ADDRESS)
+                                         CHIP8_FOR_EACH_SUPERINSTRUCTION(CHIP8_SUPERINSTRUCTION_HANDLER_ADDRESS)};
+
+    goto* handlers[instruction.index];
+    CHIP8_FOR_EACH_INSTRUCTION(CHIP8_HANDLER)
+    CHIP8_FOR_EACH_SUPERINSTRUCTION(CHIP8_SUPERINSTRUCTION_HANDLER)
+
+#undef CHIP8_SUPERINSTRUCTION_HANDLER
+#undef CHIP8_HANDLER
+#undef CHIP8_SUPERINSTRUCTION_HANDLER_ADDRESS
+#undef CHIP8_HANDLER_ADDRESS
+#else
+#define CHIP8_HANDLER(number)                                                                                                              \
+    case number:                                                                                                                           \
+        CHIP8_EXECUTE_INSTRUCTION(number)                                                                                                  \
+        break;
+#define CHIP8_SUPERINSTRUCTION_HANDLER(number, first, second)                                                                              \
+    case number:                                                                                                                           \
+        CHIP8_EXECUTE_INSTRUCTION(InstructionSet::getIndex(first))                                                                         \
+        CHIP8_FETCH_NEXT_INSTRUCTION()                                                                                                     \
+        if (instruction.callback != InstructionSet::template getCallback<InstructionSet::getIndex(second)>())                              \
+        {                                                                                                                                  \
+            continue;                                                                                                                      \
+        }                                                                                                                                  \
+        CHIP8_EXECUTE_INSTRUCTION(InstructionSet::getIndex(second))                                                                        \
+        break;
+
+    while (true)
     {
-        throw CpuExecutionException(CpuErrorCode::StackOverflow);
+        switch (instruction.index)
+        {
+            CHIP8_FOR_EACH_INSTRUCTION(CHIP8_HANDLER)
+            CHIP8_FOR_EACH_SUPERINSTRUCTION(CHIP8_SUPERINSTRUCTION_HANDLER)
+        }
+
+        CHIP8_FETCH_NEXT_INSTRUCTION()
     }
+
+#undef CHIP8_SUPERINSTRUCTION_HANDLER
+#undef CHIP8_HANDLER
+#endif
 }
 
-void chip8::Cpu::execute_sys_addr(uint16_t addr)
+#undef CHIP8_COMPUTED_GOTO
+#undef CHIP8_FETCH_NEXT_INSTRUCTION
+#undef CHIP8_EXECUTE_INSTRUCTION
+#undef CHIP8_FOR_EACH_SUPERINSTRUCTION
+#undef CHIP8_FOR_EACH_INSTRUCTION
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runCompiledCode(const size_t maxInstructions)
+{
+    const uint8_t* block = jitCompiler->getBlock(*registers.PC);
+    if (block == nullptr)
+    {
+        return 0;
+    }
+
+    return runNativeCode(maxInstructions, [this, block](JitCompiler::State& nativeState) { jitCompiler->execute(nativeState, block); });
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runCompiledRom(const size_t maxInstructions)
+{
+    if (!compiledRomLoaded)
+    {
+        return 0;
+    }
+
+    return runNativeCode(maxInstructions, compiledRom->run);
+}
+
+// Native code neither writes the timers nor waits, so timers, audio and CPU state are updated once it has run. It reads the delay timer as
+// it was on entry: exact for timers that only change between runs (FrameTimer), a tick late at most otherwise. Returns 0 if no instruction
+// was executed.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+template <typename NativeCode>
+size_t chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::runNativeCode(const size_t maxInstructions, NativeCode nativeCode)
+{
+    const int64_t budget = static_cast<int64_t>(std::min<size_t>(maxInstructions, std::numeric_limits<int64_t>::max()));
+    CompiledRom::State nativeState{registers.V, *registers.I, *registers.PC, budget, modifiedMemory.data(), delayTimer.getValue()};
+    nativeCode(nativeState);
+
+    const size_t executedInstructions = static_cast<size_t>(budget - nativeState.budget);
+    if (executedInstructions == 0)
+    {
+        return 0;
+    }
+
+    registers.V = nativeState.V;
+    registers.I = nativeState.I;
+    registers.PC = nativeState.PC;
+
+    delayTimer.updateValue();
+    soundTimer.updateValue();
+    playAudioFlag = soundTimer.getValue() > 0;
+
+    state = CpuState::Running;
+    return executedInstructions;
+}
+
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_sys_addr(uint16_t addr)
 {
     throw chip8::CpuExecutionException(CpuErrorCode::UnsupportedSysInstruction);
 }
 
-void chip8::Cpu::execute_cls()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_cls()
 {
     gpu.clear();
+    frameDirty = true;
 }
 
-void chip8::Cpu::execute_ret()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ret()
 {
     uint8_t byte2 = stack[registers.SP - 1];
     uint8_t byte1 = stack[registers.SP - 2];
@@ -207,20 +743,24 @@ void chip8::Cpu::execute_ret()
     registers.SP -= 2;
 }
 
-void chip8::Cpu::execute_jp_addr(uint16_t addr)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_jp_addr(uint16_t addr)
 {
     registers.PC = addr;
 }
 
-void chip8::Cpu::execute_call_addr(uint16_t addr)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_call_addr(uint16_t addr)
 {
-    stack[*registers.SP] = static_cast<uint8_t>((*registers.PC & 0xFF00) >> 8);
+    // Write the second byte first: validating its address also guarantees the first one is within the stack.
     stack[registers.SP + 1] = static_cast<uint8_t>(*registers.PC & 0x00FF);
+    stack[*registers.SP] = static_cast<uint8_t>((*registers.PC & 0xFF00) >> 8);
     registers.SP += 2;
     registers.PC = addr;
 }
 
-void chip8::Cpu::execute_se_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_se_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
 {
     if (registers.V[Vx] == byte)
     {
@@ -228,7 +768,8 @@ void chip8::Cpu::execute_se_vx_byte(binding::MatchingPatternType Vx, uint8_t byt
     }
 }
 
-void chip8::Cpu::execute_sne_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_sne_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
 {
     if (registers.V[Vx] != byte)
     {
@@ -236,7 +777,8 @@ void chip8::Cpu::execute_sne_vx_byte(binding::MatchingPatternType Vx, uint8_t by
     }
 }
 
-void chip8::Cpu::execute_se_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_se_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     if (registers.V[Vx] == registers.V[Vy])
     {
@@ -244,70 +786,85 @@ void chip8::Cpu::execute_se_vx_vy(binding::MatchingPatternType Vx, binding::Matc
     }
 }
 
-void chip8::Cpu::execute_ld_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
 {
     registers.V[Vx] = byte;
 }
 
-void chip8::Cpu::execute_add_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_add_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
 {
     registers.V[Vx] = registers.V[Vx] + byte;
 }
 
-void chip8::Cpu::execute_ld_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[Vx] = registers.V[Vy];
 }
 
-void chip8::Cpu::execute_or_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_or_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[Vx] = registers.V[Vx] | registers.V[Vy];
 }
 
-void chip8::Cpu::execute_and_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_and_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[Vx] = registers.V[Vx] & registers.V[Vy];
 }
 
-void chip8::Cpu::execute_xor_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_xor_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[Vx] = registers.V[Vx] ^ registers.V[Vy];
 }
 
-void chip8::Cpu::execute_add_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+// The instructions setting VF write Vx and VF one after the other, each write seeing the previous one, which decides the result when Vx or
+// Vy is VF: add, sub and subn write Vx then the flag, so VF ends up holding the flag, while shr and shl write the flag then shift Vx, so
+// VF ends up holding the shifted flag. The other execution backends (JitCompiler, the ahead-of-time translator, LockstepCpu) keep this order.
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_add_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     uint8_t originalVx = registers.V[Vx];
     registers.V[Vx] = registers.V[Vx] + registers.V[Vy];
     registers.V[VF] = (registers.V[Vx] < originalVx);
 }
 
-void chip8::Cpu::execute_sub_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_sub_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     uint8_t originalVx = registers.V[Vx];
     registers.V[Vx] = registers.V[Vx] - registers.V[Vy];
     registers.V[VF] = (registers.V[Vx] <= originalVx);
 }
 
-void chip8::Cpu::execute_shr_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_shr_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[VF] = ((registers.V[Vx] & 0b00000001) == 1);
     registers.V[Vx] = registers.V[Vx] >> 1;
 }
 
-void chip8::Cpu::execute_subn_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_subn_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     uint8_t originalVy = registers.V[Vy];
     registers.V[Vx] = registers.V[Vy] - registers.V[Vx];
     registers.V[VF] = (registers.V[Vx] <= originalVy);
 }
 
-void chip8::Cpu::execute_shl_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_shl_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     registers.V[VF] = ((registers.V[Vx] & 0b10000000) == 0b10000000);
     registers.V[Vx] = registers.V[Vx] << 1;
 }
 
-void chip8::Cpu::execute_sne_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_sne_vx_vy(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy)
 {
     if (registers.V[Vx] != registers.V[Vy])
     {
@@ -315,32 +872,43 @@ void chip8::Cpu::execute_sne_vx_vy(binding::MatchingPatternType Vx, binding::Mat
     }
 }
 
-void chip8::Cpu::execute_ld_i_addr(uint16_t addr)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_i_addr(uint16_t addr)
 {
     registers.I = addr;
 }
 
-void chip8::Cpu::execute_jp_v0_addr(uint16_t addr)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_jp_v0_addr(uint16_t addr)
 {
     registers.PC = registers.V[0] + addr;
 }
 
-void chip8::Cpu::execute_rnd_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_rnd_vx_byte(binding::MatchingPatternType Vx, uint8_t byte)
 {
-    const uint8_t randomNumber = static_cast<uint8_t>(uniformDistrubution(randomEngine));
+    const uint8_t randomNumber = randomGenerator.next();
     registers.V[Vx] = randomNumber & byte;
 }
 
-void chip8::Cpu::execute_drw_vx_vy_nibble(binding::MatchingPatternType Vx, binding::MatchingPatternType Vy, binding::MatchingPatternType nibble)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_drw_vx_vy_nibble(binding::MatchingPatternType Vx,
+                                                                                 binding::MatchingPatternType Vy,
+                                                                                 binding::MatchingPatternType nibble)
 {
-    const size_t spriteStartLocation = *registers.I;
-    const size_t spriteEndLocation = registers.I + nibble;
-    std::vector<uint8_t> sprite(memory.begin() + spriteStartLocation, memory.begin() + spriteEndLocation);
-    registers.V[VF] = gpu.setSprite(registers.V[Vx], registers.V[Vy], sprite);
+    // Copied byte by byte, as the sprite may wrap around the end of memory.
+    std::array<uint8_t, 15> sprite;
+    for (size_t i = 0; i < nibble; i++)
+    {
+        sprite[i] = memory[registers.I + static_cast<uint16_t>(i)];
+    }
+    registers.V[VF] = gpu.setSprite(registers.V[Vx], registers.V[Vy], std::span<const uint8_t>(sprite.data(), nibble));
     state = CpuState::WaitForDraw;
+    frameDirty = true;
 }
 
-void chip8::Cpu::execute_skp_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_skp_vx(binding::MatchingPatternType Vx)
 {
     if (registers.V[Vx] >= keyPressedStatus.size())
     {
@@ -353,7 +921,8 @@ void chip8::Cpu::execute_skp_vx(binding::MatchingPatternType Vx)
     }
 }
 
-void chip8::Cpu::execute_sknp_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_sknp_vx(binding::MatchingPatternType Vx)
 {
     if (registers.V[Vx] >= keyPressedStatus.size())
     {
@@ -366,12 +935,14 @@ void chip8::Cpu::execute_sknp_vx(binding::MatchingPatternType Vx)
     }
 }
 
-void chip8::Cpu::execute_ld_vx_dt(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_vx_dt(binding::MatchingPatternType Vx)
 {
     registers.V[Vx] = delayTimer.getValue();
 }
 
-void chip8::Cpu::execute_ld_vx_k(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_vx_k(binding::MatchingPatternType Vx)
 {
     // Find a key pressed.
     for (size_t i = 0; i < keyPressedStatus.size(); i++)
@@ -381,44 +952,53 @@ void chip8::Cpu::execute_ld_vx_k(binding::MatchingPatternType Vx)
         {
             registers.V[Vx] = static_cast<uint8_t>(i);
             keyPressedStatus[i] = false;
-            state = CpuState::WaitForKey;
             return;
         }
     }
 
     // If no key is found, try again on next step.
     registers.PC -= 2;
+    state = CpuState::WaitForKey;
 }
 
-void chip8::Cpu::execute_ld_dt_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_dt_vx(binding::MatchingPatternType Vx)
 {
     delayTimer.setValue(registers.V[Vx]);
 }
 
-void chip8::Cpu::execute_ld_st_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_st_vx(binding::MatchingPatternType Vx)
 {
     soundTimer.setValue(registers.V[Vx]);
 }
 
-void chip8::Cpu::execute_add_i_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_add_i_vx(binding::MatchingPatternType Vx)
 {
     registers.I += registers.V[Vx];
 }
 
-void chip8::Cpu::execute_ld_f_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_f_vx(binding::MatchingPatternType Vx)
 {
     registers.I = registers.V[Vx] * chip8::FontCharacterHeight; // I = Vx * 5
 }
 
-void chip8::Cpu::execute_ld_b_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_b_vx(binding::MatchingPatternType Vx)
 {
     memory[*registers.I] = registers.V[Vx] / 100;
     memory[registers.I + 1] = (registers.V[Vx] / 10) % 10;
     memory[registers.I + 2] = registers.V[Vx] % 10;
+    invalidateDecodedInstructions(*registers.I, 3);
 }
 
-void chip8::Cpu::execute_ld_idata_vx(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_idata_vx(binding::MatchingPatternType Vx)
 {
+    invalidateDecodedInstructions(*registers.I, Vx + 1);
+
     for (size_t i = 0; i <= Vx; i++)
     {
         memory[*registers.I] = registers.V[i];
@@ -426,7 +1006,8 @@ void chip8::Cpu::execute_ld_idata_vx(binding::MatchingPatternType Vx)
     }
 }
 
-void chip8::Cpu::execute_ld_vx_idata(binding::MatchingPatternType Vx)
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::execute_ld_vx_idata(binding::MatchingPatternType Vx)
 {
     for (size_t i = 0; i <= Vx; i++)
     {
@@ -435,7 +1016,13 @@ void chip8::Cpu::execute_ld_vx_idata(binding::MatchingPatternType Vx)
     }
 }
 
-void chip8::Cpu::onUnmatchedInstruction()
+template <typename GpuType, typename TimerType, typename BoundsPolicy>
+void chip8::BasicCpu<GpuType, TimerType, BoundsPolicy>::onUnmatchedInstruction()
 {
     throw CpuExecutionException(CpuErrorCode::UnmatchedInstruction);
-}
\ No newline at end of file
+}
+
+template class chip8::BasicCpu<chip8::IGpu, chip8::ITimer, chip8::CheckedBounds>;
+template class chip8::BasicCpu<chip8::IGpu, chip8::ITimer, chip8::WrappedBounds>;
+template class chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>;
+template class chip8::BasicCpu<chip8::Gpu, chip8::Timer>;
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "cpu/CpuSnapshot.hpp"
+
+#include <algorithm>
+#include <cpu/CpuState.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/SnapshotFormatException.hpp>
+#include <string>
+
+static_assert(chip8::CpuSnapshot::FrameBufferHeight == chip8::Gpu::Height);
+
+namespace
+{
+    constexpr std::array<char, 4> Magic = {'C', 'H', '8', 'S'};
+
+    // Little-endian, whatever the host.
+    template <typename Value>
+    void write(std::ostream& stream, const Value value)
+    {
+        for (size_t i = 0; i < sizeof(Value); i++)
+        {
+            stream.put(static_cast<char>(static_cast<uint64_t>(value) >> (8 * i)));
+        }
+    }
+
+    template <typename Value, size_t size>
+    void write(std::ostream& stream, const std::array<Value, size>& values)
+    {
+        for (const Value value : values)
+        {
+            write(stream, value);
+        }
+    }
+
+    template <size_t size>
+    void write(std::ostream& stream, const std::array<uint8_t, size>& values)
+    {
+        stream.write(reinterpret_cast<const char*>(values.data()), size);
+    }
+
+    void readBytes(std::istream& stream, uint8_t* bytes, const size_t size)
+    {
+        if (!stream.read(reinterpret_cast<char*>(bytes), static_cast<std::streamsize>(size)))
+        {
+            throw chip8::SnapshotFormatException("unexpected end of file");
+        }
+    }
+
+    template <typename Value>
+    void read(std::istream& stream, Value& value)
+    {
+        std::array<uint8_t, sizeof(Value)> bytes;
+        readBytes(stream, bytes.data(), bytes.size());
+
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(Value); i++)
+        {
+            result |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        value = static_cast<Value>(result);
+    }
+
+    template <typename Value, size_t size>
+    void read(std::istream& stream, std::array<Value, size>& values)
+    {
+        for (Value& value : values)
+        {
+            read(stream, value);
+        }
+    }
+
+    template <size_t size>
+    void read(std::istream& stream, std::array<uint8_t, size>& values)
+    {
+        readBytes(stream, values.data(), size);
+    }
+}
+
+void chip8::writeSnapshot(std::ostream& stream, const chip8::CpuSnapshot& snapshot)
+{
+    stream.write(Magic.data(), Magic.size());
+    write(stream, chip8::CpuSnapshot::Version);
+    write(stream, static_cast<uint32_t>(sizeof(chip8::CpuSnapshot)));
+
+    write(stream, snapshot.randomState);
+    write(stream, snapshot.frameBuffer);
+    write(stream, snapshot.memory);
+    write(stream, snapshot.stack);
+    write(stream, snapshot.V);
+    write(stream, snapshot.I);
+    write(stream, snapshot.PC);
+    write(stream, snapshot.keys);
+    write(stream, snapshot.SP);
+    write(stream, snapshot.delayTimer);
+    write(stream, snapshot.soundTimer);
+    write(stream, snapshot.playAudio);
+    write(stream, snapshot.state);
+    write(stream, snapshot.unused);
+}
+
+chip8::CpuSnapshot chip8::readSnapshot(std::istream& stream)
+{
+    std::array<uint8_t, Magic.size()> magic;
+    uint32_t version = 0;
+    uint32_t size = 0;
+    read(stream, magic);
+    read(stream, version);
+    read(stream, size);
+
+    if (!std::equal(magic.begin(), magic.end(), Magic.begin(), [](const uint8_t byte, const char character) { return byte == character; }))
+    {
+        throw chip8::SnapshotFormatException("not a snapshot");
+    }
+
+    if (version != chip8::CpuSnapshot::Version || size != sizeof(chip8::CpuSnapshot))
+    {
+        throw chip8::SnapshotFormatException("unsupported version " + std::to_string(version));
+    }
+
+    chip8::CpuSnapshot snapshot{};
+    read(stream, snapshot.randomState);
+    read(stream, snapshot.frameBuffer);
+    read(stream, snapshot.memory);
+    read(stream, snapshot.stack);
+    read(stream, snapshot.V);
+    read(stream, snapshot.I);
+    read(stream, snapshot.PC);
+    read(stream, snapshot.keys);
+    read(stream, snapshot.SP);
+    read(stream, snapshot.delayTimer);
+    read(stream, snapshot.soundTimer);
+    read(stream, snapshot.playAudio);
+    read(stream, snapshot.state);
+    read(stream, snapshot.unused);
+
+    // Registers a CPU could not hold, whatever its bounds policy (the bounds of BasicCpu::restore).
+    if (snapshot.I > snapshot.memory.size() || snapshot.PC > snapshot.memory.size() || snapshot.SP > snapshot.stack.size() ||
+        snapshot.state > static_cast<uint8_t>(chip8::CpuState::WaitForKey))
+    {
+        throw chip8::SnapshotFormatException("invalid registers");
+    }
+
+    return snapshot;
+}
\ No newline at end of file
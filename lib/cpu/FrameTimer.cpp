@@ -0,0 +1,12 @@
+#include "cpu/FrameTimer.hpp"
+
+chip8::FrameTimer::FrameTimer(const chip8::FrameClock& clock)
+    : clock(clock)
+{
+}
+
+void chip8::FrameTimer::setValue(const uint8_t value)
+{
+    valueSet = value;
+    frameSet = clock.getFrame();
+}
\ No newline at end of file
@@ -1,60 +1,77 @@
 #include "cpu/Gpu.hpp"
 
+#include <algorithm>
+#include <bit>
+
 chip8::Gpu::Gpu(const logging::Logger& logger)
     : logger(logger)
-    , frameBuffer(getWidth() * getHeight())
+    , frameBuffer{}
+    , shownFrameBuffer{}
+    , drawnRows(0)
 {
 }
 
 void chip8::Gpu::clear()
 {
-    std::fill(frameBuffer.begin(), frameBuffer.end(), 0);
+    frameBuffer.fill(0);
+    drawnRows = static_cast<uint32_t>((uint64_t(1) << Height) - 1);
 }
 
-bool chip8::Gpu::setSprite(const size_t x, const size_t y, const std::vector<uint8_t>& sprite)
+bool chip8::Gpu::setSprite(const size_t x, const size_t y, const std::span<const uint8_t> sprite)
 {
-    size_t currentLine = y;
-    static constexpr size_t PixelsPerRow = sizeof(uint8_t) * 8;
-    bool anyPixelErased = false;
+    return drawSprite(frameBuffer, x, y, sprite, drawnRows);
+}
 
-    for (const uint8_t row : sprite)
-    {
-        // Cut the part of the sprite going out of screen
-        if (currentLine >= getHeight())
-        {
-            return anyPixelErased;
-        }
+std::span<const uint64_t> chip8::Gpu::getFrameBuffer() const
+{
+    return frameBuffer;
+}
+
+void chip8::Gpu::setFrameBuffer(const std::span<const uint64_t> frameBuffer)
+{
+    std::copy_n(frameBuffer.begin(), std::min(frameBuffer.size(), Height), this->frameBuffer.begin());
+    drawnRows = static_cast<uint32_t>((uint64_t(1) << Height) - 1);
+}
 
-        for (size_t i = 0; i < PixelsPerRow; i++)
+uint32_t chip8::Gpu::getDirtyRows() const
+{
+    uint32_t dirtyRows = 0;
+    for (uint32_t rows = drawnRows; rows != 0; rows &= rows - 1)
+    {
+        const int y = std::countr_zero(rows);
+        if (frameBuffer[y] != shownFrameBuffer[y])
         {
-            bool bit_i = (row >> (PixelsPerRow - i - 1)) % 2;
-            const size_t bitLocationInScreen = (currentLine * getWidth() + ((x + i) % getWidth())); // Modulo getWidth() wraps around
-            bool pixel = frameBuffer[bitLocationInScreen] ^ bit_i;
-            if (!pixel && frameBuffer[bitLocationInScreen])
-            {
-                anyPixelErased = true;
-            }
-
-            frameBuffer[bitLocationInScreen] = pixel;
+            dirtyRows |= uint32_t(1) << y;
         }
-
-        currentLine++;
     }
 
-    return anyPixelErased;
+    return dirtyRows;
 }
 
-const std::vector<bool>& chip8::Gpu::getFrameBuffer() const
+void chip8::Gpu::onDrawComplete()
 {
-    return frameBuffer;
+    shownFrameBuffer = frameBuffer;
+    drawnRows = 0;
 }
 
-size_t chip8::Gpu::getWidth()
+bool chip8::Gpu::drawSprite(const std::span<uint64_t, Height> frameBuffer,
+                            const size_t x,
+                            const size_t y,
+                            const std::span<const uint8_t> sprite,
+                            uint32_t& drawnRows)
 {
-    return 64;
-}
+    // Rotating moves the sprite to column x, wrapping around the right edge.
+    const int shift = static_cast<int>(x % Width);
+    uint64_t erasedPixels = 0;
 
-size_t chip8::Gpu::getHeight()
-{
-    return 32;
+    // Cut the part of the sprite going out of screen
+    for (size_t line = y, i = 0; line < Height && i < sprite.size(); line++, i++)
+    {
+        const uint64_t spriteRow = std::rotr(static_cast<uint64_t>(sprite[i]) << (Width - 8), shift);
+        erasedPixels |= frameBuffer[line] & spriteRow;
+        frameBuffer[line] ^= spriteRow;
+        drawnRows |= uint32_t(1) << line;
+    }
+
+    return erasedPixels != 0;
 }
\ No newline at end of file
@@ -0,0 +1,621 @@
+#include "JitCompiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "NativeInstructions.hpp"
+
+#if defined(__x86_64__) && defined(__linux__)
+#define CHIP8_JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    // x86-64 registers, numbered as in instruction encodings.
+    enum Register : uint8_t
+    {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15
+    };
+
+    enum Condition : uint8_t
+    {
+        Below = 0x2,
+        Equal = 0x4,
+        NotEqual = 0x5,
+        BelowOrEqual = 0x6,
+        Less = 0xC,
+        Always = 0xFF
+    };
+
+    // Generated code receives the state in RDI. RAX and RCX are scratch registers, the others hold V registers.
+    constexpr std::array<uint8_t, 12> AllocatableRegisters{RDX, RBX, RBP, RSI, R8, R9, R10, R11, R12, R13, R14, R15};
+    constexpr uint8_t VF = 0xF;
+
+    constexpr uint8_t VOffset = offsetof(chip8::JitCompiler::State, V);
+    constexpr uint8_t IOffset = offsetof(chip8::JitCompiler::State, I);
+    constexpr uint8_t PCOffset = offsetof(chip8::JitCompiler::State, PC);
+    constexpr uint8_t BudgetOffset = offsetof(chip8::JitCompiler::State, budget);
+    constexpr uint8_t DelayTimerOffset = offsetof(chip8::JitCompiler::State, delayTimer);
+
+    // Bit i is set if the instruction reads or writes Vi.
+    uint16_t getUsedRegisters(const uint8_t byte1, const uint8_t byte2)
+    {
+        const uint16_t x = 1 << (byte1 & 0x0F);
+        const uint16_t y = 1 << (byte2 >> 4);
+
+        switch (byte1 >> 4)
+        {
+        case 0x3:
+        case 0x4:
+        case 0x6:
+        case 0x7:
+        case 0xF:
+            return x;
+        case 0x5:
+        case 0x9:
+            return x | y;
+        case 0x8:
+            return (byte2 & 0x0F) <= 0x3 ? x | y : x | y | (1 << VF);
+        default:
+            return 0;
+        }
+    }
+
+    // Bit i is set if the instruction writes Vi.
+    uint16_t getWrittenRegisters(const uint8_t byte1, const uint8_t byte2)
+    {
+        const uint16_t x = 1 << (byte1 & 0x0F);
+
+        switch (byte1 >> 4)
+        {
+        case 0x6:
+        case 0x7:
+        case 0xF:
+            return x;
+        case 0x8:
+            return (byte2 & 0x0F) <= 0x3 ? x : x | (1 << VF);
+        default:
+            return 0;
+        }
+    }
+}
+
+chip8::JitCompiler::JitCompiler(const uint8_t* memory, const size_t memorySize)
+    : memory(memory)
+    , memorySize(memorySize)
+    , code(nullptr)
+    , codeSize(0)
+    , epilogue(0)
+    , blocks(memorySize, NotCompiled)
+    , pendingJumps(memorySize)
+    , compiledMemory(memorySize)
+{
+#ifdef CHIP8_JIT_SUPPORTED
+    void* buffer = mmap(nullptr, CodeBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot allocate memory for compiled code");
+    }
+
+    code = static_cast<uint8_t*>(buffer);
+    emitTrampoline();
+    if (mprotect(code, CodeBufferSize, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(code, CodeBufferSize);
+        throw std::runtime_error("Cannot make compiled code executable");
+    }
+#endif
+}
+
+chip8::JitCompiler::~JitCompiler()
+{
+#ifdef CHIP8_JIT_SUPPORTED
+    munmap(code, CodeBufferSize);
+#endif
+}
+
+bool chip8::JitCompiler::isSupported()
+{
+#ifdef CHIP8_JIT_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+}
+
+const uint8_t* chip8::JitCompiler::getBlock(const uint16_t address)
+{
+    if (code == nullptr || static_cast<size_t>(address) + 1 >= memorySize)
+    {
+        return nullptr;
+    }
+
+    if (blocks[address] == NotCompiled)
+    {
+        setWritable(true);
+        if (codeSize + MaxBlockCodeSize > CodeBufferSize)
+        {
+            flush();
+        }
+
+        compileBurst(address);
+        setWritable(false);
+    }
+
+    return blocks[address] >= 0 ? code + blocks[address] : nullptr;
+}
+
+void chip8::JitCompiler::execute(State& state, const uint8_t* block) const
+{
+    using Trampoline = void (*)(State*, const uint8_t*);
+    reinterpret_cast<Trampoline>(code)(&state, block);
+}
+
+void chip8::JitCompiler::invalidate(const uint16_t address, const size_t length)
+{
+    const size_t first = std::min(static_cast<size_t>(address), memorySize);
+    const size_t last = std::min(static_cast<size_t>(address) + length, memorySize);
+    if (std::find(compiledMemory.begin() + first, compiledMemory.begin() + last, true) != compiledMemory.begin() + last)
+    {
+        setWritable(true);
+        flush();
+        setWritable(false);
+    }
+}
+
+// The code buffer is never writable and executable at the same time, which hardened kernels and SELinux policies refuse: it is only
+// writable while code is generated.
+void chip8::JitCompiler::setWritable(const bool writable)
+{
+#ifdef CHIP8_JIT_SUPPORTED
+    if (mprotect(code, CodeBufferSize, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) != 0)
+    {
+        throw std::runtime_error("Cannot change the protection of compiled code");
+    }
+#endif
+}
+
+bool chip8::JitCompiler::isCompilable(const uint16_t address) const
+{
+    return chip8::isNativeInstruction(memory[address], memory[address + 1], address);
+}
+
+bool chip8::JitCompiler::isBranch(const Instruction instruction)
+{
+    switch (instruction.byte1 >> 4)
+    {
+    case 0x1:
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Compiles the block at start, then breadth first the blocks it may continue at, within MaxBurstBlocks and the space left in the buffer.
+void chip8::JitCompiler::compileBurst(const uint16_t start)
+{
+    std::vector<uint16_t> addresses{start};
+    for (size_t i = 0; i < addresses.size() && i < MaxBurstBlocks && codeSize + MaxBlockCodeSize <= CodeBufferSize; i++)
+    {
+        if (static_cast<size_t>(addresses[i]) + 1 < memorySize && blocks[addresses[i]] == NotCompiled)
+        {
+            compileBlock(addresses[i], addresses);
+        }
+    }
+}
+
+// Appends the addresses the block may continue at to successors.
+void chip8::JitCompiler::compileBlock(const uint16_t start, std::vector<uint16_t>& successors)
+{
+    std::vector<Instruction> instructions;
+    uint16_t usedRegisters = 0;
+    uint16_t writtenRegisters = 0;
+
+    for (size_t address = start; instructions.size() < MaxBlockLength && address + 1 < memorySize; address += 2)
+    {
+        if (!isCompilable(static_cast<uint16_t>(address)))
+        {
+            break;
+        }
+
+        const Instruction instruction{memory[address], memory[address + 1]};
+        const uint16_t registers = usedRegisters | getUsedRegisters(instruction.byte1, instruction.byte2);
+        if (static_cast<size_t>(std::popcount(registers)) > AllocatableRegisters.size())
+        {
+            break;
+        }
+
+        usedRegisters = registers;
+        writtenRegisters |= getWrittenRegisters(instruction.byte1, instruction.byte2);
+        instructions.push_back(instruction);
+
+        if (isBranch(instruction))
+        {
+            break;
+        }
+    }
+
+    if (instructions.empty())
+    {
+        blocks[start] = NotCompilable;
+        return;
+    }
+
+    const size_t entry = codeSize;
+    const uint32_t length = static_cast<uint32_t>(instructions.size());
+    const uint16_t next = static_cast<uint16_t>(start + 2 * length);
+
+    // Registered before emitting the exits so that a block jumping to itself does so directly.
+    blocks[start] = static_cast<int32_t>(entry);
+    for (const size_t location : pendingJumps[start])
+    {
+        patchJump(location, entry);
+    }
+    pendingJumps[start].clear();
+    std::fill(compiledMemory.begin() + start, compiledMemory.begin() + next, true);
+
+    // Return if the budget is too small: cmp qword [rdi + budget], length; jl epilogue; sub qword [rdi + budget], length.
+    emit8(0x48);
+    emit8(0x81);
+    emit8(0x7F);
+    emit8(BudgetOffset);
+    emit32(length);
+    patchJump(emitJump(Less), epilogue);
+    emit8(0x48);
+    emit8(0x81);
+    emit8(0x6F);
+    emit8(BudgetOffset);
+    emit32(length);
+
+    std::array<uint8_t, 16> allocation{};
+    size_t allocatedRegisters = 0;
+    for (uint8_t i = 0; i < allocation.size(); i++)
+    {
+        if (usedRegisters & (1 << i))
+        {
+            allocation[i] = AllocatableRegisters[allocatedRegisters++];
+            emitLoad(allocation[i], VOffset + i);
+        }
+    }
+
+    // I is only ever assigned constants, so only the last one needs storing.
+    int32_t I = -1;
+    const Instruction last = instructions.back();
+    const size_t bodyLength = isBranch(last) ? instructions.size() - 1 : instructions.size();
+    for (size_t i = 0; i < bodyLength; i++)
+    {
+        if ((instructions[i].byte1 >> 4) == 0xA)
+        {
+            I = ((instructions[i].byte1 & 0x0F) << 8) | instructions[i].byte2;
+        }
+        else
+        {
+            emitInstruction(instructions[i], allocation);
+        }
+    }
+
+    const uint8_t x = allocation[last.byte1 & 0x0F];
+    const uint8_t y = allocation[last.byte2 >> 4];
+
+    switch (isBranch(last) ? last.byte1 >> 4 : 0)
+    {
+    case 0x1:
+    {
+        const uint16_t target = static_cast<uint16_t>(((last.byte1 & 0x0F) << 8) | last.byte2);
+        emitStores(allocation, writtenRegisters, I);
+        emitExit(target);
+        successors.push_back(target);
+        break;
+    }
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+    {
+        // Stores do not change the flags set by the comparison.
+        if ((last.byte1 >> 4) == 0x3 || (last.byte1 >> 4) == 0x4)
+        {
+            emitImmediateOperation(7, x, last.byte2); // cmp Vx, byte
+        }
+        else
+        {
+            emitRegisterOperation(0x38, x, y); // cmp Vx, Vy
+        }
+
+        emitStores(allocation, writtenRegisters, I);
+        const size_t skip = emitJump((last.byte1 >> 4) == 0x3 || (last.byte1 >> 4) == 0x5 ? Equal : NotEqual);
+        emitExit(next);
+        patchJump(skip, codeSize);
+        emitExit(next + 2);
+        successors.push_back(next);
+        successors.push_back(next + 2);
+        break;
+    }
+    default:
+        emitStores(allocation, writtenRegisters, I);
+        emitExit(next);
+        successors.push_back(next);
+        break;
+    }
+}
+
+void chip8::JitCompiler::flush()
+{
+    std::fill(blocks.begin(), blocks.end(), NotCompiled);
+    for (std::vector<size_t>& jumps : pendingJumps)
+    {
+        jumps.clear();
+    }
+    std::fill(compiledMemory.begin(), compiledMemory.end(), false);
+
+    codeSize = 0;
+    emitTrampoline();
+}
+
+// Called as void(State* state, const uint8_t* block): saves the callee-saved registers and jumps to the block. Blocks return through the
+// epilogue.
+void chip8::JitCompiler::emitTrampoline()
+{
+    emit8(0x53); // push rbx
+    emit8(0x55); // push rbp
+    emit16(0x5441); // push r12
+    emit16(0x5541); // push r13
+    emit16(0x5641); // push r14
+    emit16(0x5741); // push r15
+    emit16(0xE6FF); // jmp rsi
+
+    epilogue = codeSize;
+    emit16(0x5F41); // pop r15
+    emit16(0x5E41); // pop r14
+    emit16(0x5D41); // pop r13
+    emit16(0x5C41); // pop r12
+    emit8(0x5D); // pop rbp
+    emit8(0x5B); // pop rbx
+    emit8(0xC3); // ret
+}
+
+// Writes Vx and VF in the order of the interpreter (see execute_add_vx_vy in Cpu.cpp). Vx and VF are then the same host register when x is
+// F, so shifts operate on that register after the flag has been moved into it.
+void chip8::JitCompiler::emitInstruction(const Instruction instruction, const std::array<uint8_t, 16>& allocation)
+{
+    const uint8_t x = allocation[instruction.byte1 & 0x0F];
+    const uint8_t y = allocation[instruction.byte2 >> 4];
+    const uint8_t f = allocation[VF];
+
+    if ((instruction.byte1 >> 4) == 0x6)
+    {
+        emitLoadImmediate(x, instruction.byte2);
+        return;
+    }
+
+    if ((instruction.byte1 >> 4) == 0x7)
+    {
+        emitImmediateOperation(0, x, instruction.byte2); // add Vx, byte
+        return;
+    }
+
+    if ((instruction.byte1 >> 4) == 0xF)
+    {
+        emitLoad(x, DelayTimerOffset); // ld Vx, DT
+        return;
+    }
+
+    switch (instruction.byte2 & 0x0F)
+    {
+    case 0x0:
+        emitRegisterOperation(0x88, x, y); // mov Vx, Vy
+        break;
+    case 0x1:
+        emitRegisterOperation(0x08, x, y); // or Vx, Vy
+        break;
+    case 0x2:
+        emitRegisterOperation(0x20, x, y); // and Vx, Vy
+        break;
+    case 0x3:
+        emitRegisterOperation(0x30, x, y); // xor Vx, Vy
+        break;
+    case 0x4:
+        emitRegisterOperation(0x88, RAX, x); // mov al, Vx
+        emitRegisterOperation(0x00, x, y);   // add Vx, Vy
+        emitRegisterOperation(0x38, x, RAX); // cmp Vx, al
+        emitSetCondition(Below, f);
+        break;
+    case 0x5:
+        emitRegisterOperation(0x88, RAX, x); // mov al, Vx
+        emitRegisterOperation(0x28, x, y);   // sub Vx, Vy
+        emitRegisterOperation(0x38, x, RAX); // cmp Vx, al
+        emitSetCondition(BelowOrEqual, f);
+        break;
+    case 0x6:
+        emitRegisterOperation(0x88, RAX, x); // mov al, Vx
+        emitImmediateOperation(4, RAX, 1);   // and al, 1
+        emitRegisterOperation(0x88, f, RAX); // mov VF, al
+        emitShift(5, x, 1);                  // shr Vx, 1
+        break;
+    case 0x7:
+        emitRegisterOperation(0x88, RAX, y); // mov al, Vy
+        emitRegisterOperation(0x88, RCX, y); // mov cl, Vy
+        emitRegisterOperation(0x28, RCX, x); // sub cl, Vx
+        emitRegisterOperation(0x88, x, RCX); // mov Vx, cl
+        emitRegisterOperation(0x38, x, RAX); // cmp Vx, al
+        emitSetCondition(BelowOrEqual, f);
+        break;
+    case 0xE:
+        emitRegisterOperation(0x88, RAX, x); // mov al, Vx
+        emitShift(5, RAX, 7);                // shr al, 7
+        emitRegisterOperation(0x88, f, RAX); // mov VF, al
+        emitShift(4, x, 1);                  // shl Vx, 1
+        break;
+    }
+}
+
+void chip8::JitCompiler::emitStores(const std::array<uint8_t, 16>& allocation, const uint16_t writtenRegisters, const int32_t I)
+{
+    for (uint8_t i = 0; i < allocation.size(); i++)
+    {
+        if (writtenRegisters & (1 << i))
+        {
+            emitStore(VOffset + i, allocation[i]);
+        }
+    }
+
+    if (I >= 0)
+    {
+        // mov word [rdi + I], imm16
+        emit8(0x66);
+        emit8(0xC7);
+        emit8(0x47);
+        emit8(IOffset);
+        emit16(static_cast<uint16_t>(I));
+    }
+}
+
+// Sets PC and jumps to the target block, or to the epilogue until the target block is compiled.
+void chip8::JitCompiler::emitExit(const uint16_t target)
+{
+    // mov word [rdi + PC], target
+    emit8(0x66);
+    emit8(0xC7);
+    emit8(0x47);
+    emit8(PCOffset);
+    emit16(target);
+
+    const size_t jump = emitJump(Always);
+    if (target < memorySize && blocks[target] >= 0)
+    {
+        patchJump(jump, blocks[target]);
+    }
+    else
+    {
+        patchJump(jump, epilogue);
+        if (target < memorySize)
+        {
+            pendingJumps[target].push_back(jump);
+        }
+    }
+}
+
+void chip8::JitCompiler::emit8(const uint8_t value)
+{
+    code[codeSize++] = value;
+}
+
+void chip8::JitCompiler::emit16(const uint16_t value)
+{
+    std::memcpy(code + codeSize, &value, sizeof(value));
+    codeSize += sizeof(value);
+}
+
+void chip8::JitCompiler::emit32(const uint32_t value)
+{
+    std::memcpy(code + codeSize, &value, sizeof(value));
+    codeSize += sizeof(value);
+}
+
+// Byte register operations always have a REX prefix, so that registers 4 to 7 are spl, bpl, sil and dil rather than ah, ch, dh and bh.
+
+// op r/m8, r8
+void chip8::JitCompiler::emitRegisterOperation(const uint8_t opcode, const uint8_t destination, const uint8_t source)
+{
+    emit8(0x40 | ((source >> 3) << 2) | (destination >> 3));
+    emit8(opcode);
+    emit8(0xC0 | ((source & 7) << 3) | (destination & 7));
+}
+
+// op r/m8, imm8
+void chip8::JitCompiler::emitImmediateOperation(const uint8_t extension, const uint8_t reg, const uint8_t immediate)
+{
+    emit8(0x40 | (reg >> 3));
+    emit8(0x80);
+    emit8(0xC0 | (extension << 3) | (reg & 7));
+    emit8(immediate);
+}
+
+// mov r8, imm8
+void chip8::JitCompiler::emitLoadImmediate(const uint8_t reg, const uint8_t immediate)
+{
+    emit8(0x40 | (reg >> 3));
+    emit8(0xB0 | (reg & 7));
+    emit8(immediate);
+}
+
+// shl/shr r/m8, imm8
+void chip8::JitCompiler::emitShift(const uint8_t extension, const uint8_t reg, const uint8_t count)
+{
+    emit8(0x40 | (reg >> 3));
+    emit8(0xC0);
+    emit8(0xC0 | (extension << 3) | (reg & 7));
+    emit8(count);
+}
+
+// setcc r/m8
+void chip8::JitCompiler::emitSetCondition(const uint8_t condition, const uint8_t reg)
+{
+    emit8(0x40 | (reg >> 3));
+    emit8(0x0F);
+    emit8(0x90 | condition);
+    emit8(0xC0 | (reg & 7));
+}
+
+// mov r8, [rdi + offset]
+void chip8::JitCompiler::emitLoad(const uint8_t reg, const uint8_t offset)
+{
+    emit8(0x40 | ((reg >> 3) << 2));
+    emit8(0x8A);
+    emit8(0x40 | ((reg & 7) << 3) | RDI);
+    emit8(offset);
+}
+
+// mov [rdi + offset], r8
+void chip8::JitCompiler::emitStore(const uint8_t offset, const uint8_t reg)
+{
+    emit8(0x40 | ((reg >> 3) << 2));
+    emit8(0x88);
+    emit8(0x40 | ((reg & 7) << 3) | RDI);
+    emit8(offset);
+}
+
+// jmp/jcc rel32. Returns the location of the displacement, to be set with patchJump.
+size_t chip8::JitCompiler::emitJump(const uint8_t condition)
+{
+    if (condition == Always)
+    {
+        emit8(0xE9);
+    }
+    else
+    {
+        emit8(0x0F);
+        emit8(0x80 | condition);
+    }
+
+    const size_t location = codeSize;
+    emit32(0);
+    return location;
+}
+
+void chip8::JitCompiler::patchJump(const size_t location, const size_t target)
+{
+    const int32_t displacement = static_cast<int32_t>(target) - static_cast<int32_t>(location + sizeof(int32_t));
+    std::memcpy(code + location, &displacement, sizeof(displacement));
+}
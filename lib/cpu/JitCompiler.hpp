@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cpu/CompiledRom.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chip8
+{
+    // Translates CHIP-8 basic blocks into x86-64 machine code (Linux only, see isSupported).
+    //
+    // Only register arithmetic, loads of constants into V and I, reads of the delay timer, jumps and skips are translated: every other
+    // instruction ends the block and is left to the interpreter. Within a block the V registers it uses are held in host registers. Blocks
+    // end with a jump to the next block, patched to jump to it directly once it is compiled, so that loops run without leaving native code.
+    // Compiling a block also compiles the blocks it may continue at, so that the code buffer is made writable once per loop or so rather
+    // than once per block.
+    class JitCompiler
+    {
+      public:
+        // Guest state read and written by the generated code, shared with ROMs translated ahead of time. The generated code depends on
+        // this layout.
+        using State = chip8::CompiledRom::State;
+
+        JitCompiler(const uint8_t* memory, const size_t memorySize);
+        ~JitCompiler();
+
+        static bool isSupported();
+
+        // Returns the native code of the block starting at address, compiling it on first use. Returns nullptr if the instruction at address
+        // cannot be compiled.
+        const uint8_t* getBlock(const uint16_t address);
+
+        // Runs blocks from the given one until the budget is too small for the next block or the next block is not compiled. Only whole
+        // blocks are executed: state.budget is decremented by the length of each of them and state.PC is the address of the next instruction.
+        void execute(State& state, const uint8_t* block) const;
+
+        // Discards all the compiled code if memory in [address, address + length) has been compiled.
+        void invalidate(const uint16_t address, const size_t length);
+
+        JitCompiler(const JitCompiler&) = delete;
+        JitCompiler& operator=(const JitCompiler&) = delete;
+
+      private:
+        struct Instruction
+        {
+            uint8_t byte1;
+            uint8_t byte2;
+        };
+
+        bool isCompilable(const uint16_t address) const;
+        static bool isBranch(const Instruction instruction);
+        void compileBurst(const uint16_t start);
+        void compileBlock(const uint16_t start, std::vector<uint16_t>& successors);
+        void flush();
+        void setWritable(const bool writable);
+
+        void emitTrampoline();
+        void emitInstruction(const Instruction instruction, const std::array<uint8_t, 16>& allocation);
+        void emitStores(const std::array<uint8_t, 16>& allocation, const uint16_t writtenRegisters, const int32_t I);
+        void emitExit(const uint16_t target);
+        void emit8(const uint8_t value);
+        void emit16(const uint16_t value);
+        void emit32(const uint32_t value);
+        void emitRegisterOperation(const uint8_t opcode, const uint8_t destination, const uint8_t source);
+        void emitImmediateOperation(const uint8_t extension, const uint8_t reg, const uint8_t immediate);
+        void emitLoadImmediate(const uint8_t reg, const uint8_t immediate);
+        void emitShift(const uint8_t extension, const uint8_t reg, const uint8_t count);
+        void emitSetCondition(const uint8_t condition, const uint8_t reg);
+        void emitLoad(const uint8_t reg, const uint8_t offset);
+        void emitStore(const uint8_t offset, const uint8_t reg);
+        size_t emitJump(const uint8_t condition);
+        void patchJump(const size_t location, const size_t target);
+
+      private:
+        static constexpr size_t CodeBufferSize = 1024 * 1024;
+        static constexpr size_t MaxBlockLength = 32;
+        static constexpr size_t MaxBlockCodeSize = 1024;
+        static constexpr size_t MaxBurstBlocks = 16;
+        static constexpr int32_t NotCompiled = -1;
+        static constexpr int32_t NotCompilable = -2;
+
+        const uint8_t* memory;
+        const size_t memorySize;
+
+        uint8_t* code;
+        size_t codeSize;
+        size_t epilogue;
+
+        // Offset in code of the block starting at each address, NotCompiled or NotCompilable.
+        std::vector<int32_t> blocks;
+        // Locations of the jumps to each address that still lead to the epilogue, to be patched once a block is compiled there.
+        std::vector<std::vector<size_t>> pendingJumps;
+        // Memory bytes translated into the compiled code.
+        std::vector<bool> compiledMemory;
+    };
+}
@@ -0,0 +1,916 @@
+#include "cpu/LockstepCpu.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cpu/Font.hpp>
+#include <cpu/InstructionBinding.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <stdexcept>
+
+#include "Simd.hpp"
+
+namespace
+{
+#ifdef CHIP8_AVX2_SUPPORTED
+    CHIP8_TARGET_AVX2 __m256i load(const uint8_t* data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+
+    CHIP8_TARGET_AVX2 __m256i load(const uint16_t* data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+
+    // 16 bytes extended to 16-bit elements: sign extension widens the masks of the group, zero extension the registers.
+    CHIP8_TARGET_AVX2 __m256i loadWidened(const uint8_t* data)
+    {
+        return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+
+    CHIP8_TARGET_AVX2 __m256i loadExtended(const uint8_t* data)
+    {
+        return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+
+    // Writes value into the selected elements (all bits set in selected), leaving the others as they are.
+    CHIP8_TARGET_AVX2 void storeSelected(uint8_t* data, const __m256i value, const __m256i selected)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_blendv_epi8(load(data), value, selected));
+    }
+
+    CHIP8_TARGET_AVX2 void storeSelected(uint16_t* data, const __m256i value, const __m256i selected)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_blendv_epi8(load(data), value, selected));
+    }
+
+    // Unsigned a <= b, all bits set where true.
+    CHIP8_TARGET_AVX2 __m256i lessOrEqual(const __m256i a, const __m256i b)
+    {
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(a, b), a);
+    }
+
+    // 1 where the condition is true, 0 elsewhere, as the instructions setting VF do.
+    CHIP8_TARGET_AVX2 __m256i toFlag(const __m256i condition)
+    {
+        return _mm256_and_si256(condition, _mm256_set1_epi8(1));
+    }
+#endif
+}
+
+chip8::LockstepCpu::LockstepCpu(const logging::Logger& logger, const size_t lanes, const chip8::SimdLevel level)
+    : logger(logger)
+    , lanes(lanes)
+    , stride((lanes + LaneAlignment - 1) / LaneAlignment * LaneAlignment)
+    , level(level)
+    , V(16 * stride)
+    , I(stride)
+    , PC(stride)
+    , SP(stride)
+    , stack(StackSize * stride)
+    , delayTimer(stride)
+    , soundTimer(stride)
+    , keys(stride)
+    , budget(stride)
+    , group(stride)
+    , waitingForKey(stride)
+    , errors(lanes)
+    , randomGenerators(lanes)
+    , frameBuffers(lanes * chip8::Gpu::Height)
+    , image{}
+    , pageTable(lanes * Pages)
+    , privateCopies{}
+{
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        for (size_t page = 0; page < Pages; page++)
+        {
+            pageTable[lane * Pages + page] = image.data() + page * PageSize;
+        }
+    }
+}
+
+void chip8::LockstepCpu::boot(std::istream& stream, const std::span<const uint64_t> seeds)
+{
+    if (seeds.size() != lanes)
+    {
+        throw std::invalid_argument("Every lane needs a seed");
+    }
+
+    stream.seekg(0, std::ios::end);
+    const size_t streamLength = stream.tellg();
+
+    if (streamLength > MemorySize - ProgramStartLocation)
+    {
+        throw chip8::RomLoadFailureException("Not enough memory to execute the program");
+    }
+
+    image.fill(0);
+    stream.seekg(0, std::ios::beg);
+    stream.read(reinterpret_cast<char*>(image.data() + ProgramStartLocation), streamLength);
+    std::copy(chip8::font.begin(), chip8::font.end(), image.begin());
+
+    std::fill(V.begin(), V.end(), 0);
+    std::fill(I.begin(), I.end(), 0);
+    std::fill(PC.begin(), PC.end(), static_cast<uint16_t>(ProgramStartLocation));
+    std::fill(SP.begin(), SP.end(), 0);
+    std::fill(stack.begin(), stack.end(), 0);
+    std::fill(delayTimer.begin(), delayTimer.end(), 0);
+    std::fill(soundTimer.begin(), soundTimer.end(), 0);
+    std::fill(keys.begin(), keys.end(), 0);
+    std::fill(budget.begin(), budget.end(), 0);
+    std::fill(group.begin(), group.end(), 0);
+    std::fill(waitingForKey.begin(), waitingForKey.end(), 0);
+    std::fill(errors.begin(), errors.end(), std::nullopt);
+    std::fill(frameBuffers.begin(), frameBuffers.end(), 0);
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        randomGenerators[lane] = chip8::RandomGenerator(chip8::RandomEngine::Xorshift, seeds[lane]);
+
+        for (size_t page = 0; page < Pages; page++)
+        {
+            pageTable[lane * Pages + page] = image.data() + page * PageSize;
+        }
+    }
+
+    freePages.clear();
+    for (const std::unique_ptr<Page>& page : privatePages)
+    {
+        freePages.push_back(page->data());
+    }
+    privateCopies.fill(0);
+}
+
+uint64_t chip8::LockstepCpu::run(const size_t maxInstructions)
+{
+    // As Cpu::run, lanes waiting for a key try again.
+    std::fill(waitingForKey.begin(), waitingForKey.end(), 0);
+    uint64_t executedInstructions = 0;
+
+    for (size_t remainingInstructions = maxInstructions; remainingInstructions > 0;)
+    {
+        const uint16_t runBudget = static_cast<uint16_t>(std::min(remainingInstructions, MaxBudget));
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            budget[lane] = errors[lane] || waitingForKey[lane] ? 0 : runBudget;
+        }
+
+        for (size_t groupSize = step(); groupSize > 0; groupSize = step())
+        {
+            executedInstructions += groupSize;
+        }
+
+        remainingInstructions -= runBudget;
+    }
+
+    return executedInstructions;
+}
+
+void chip8::LockstepCpu::tickTimers()
+{
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        delayTimer[lane] -= delayTimer[lane] > 0;
+        soundTimer[lane] -= soundTimer[lane] > 0;
+    }
+}
+
+void chip8::LockstepCpu::onKeyPressed(const size_t lane, const chip8::Key key)
+{
+    keys[lane] |= static_cast<uint16_t>(1 << static_cast<size_t>(key));
+}
+
+void chip8::LockstepCpu::onKeyReleased(const size_t lane, const chip8::Key key)
+{
+    keys[lane] &= static_cast<uint16_t>(~(1 << static_cast<size_t>(key)));
+}
+
+chip8::LockstepCpu::LaneState chip8::LockstepCpu::save(const size_t lane) const
+{
+    LaneState state;
+    for (size_t index = 0; index < state.V.size(); index++)
+    {
+        state.V[index] = V[index * stride + lane];
+    }
+
+    state.I = I[lane];
+    state.PC = PC[lane];
+    state.SP = SP[lane];
+    for (size_t index = 0; index < StackSize; index++)
+    {
+        state.stack[index] = stack[index * stride + lane];
+    }
+
+    state.delayTimer = delayTimer[lane];
+    state.soundTimer = soundTimer[lane];
+    std::copy_n(frameBuffers.begin() + lane * chip8::Gpu::Height, chip8::Gpu::Height, state.frameBuffer.begin());
+
+    for (size_t page = 0; page < Pages; page++)
+    {
+        std::copy_n(pageTable[lane * Pages + page], PageSize, state.memory.begin() + page * PageSize);
+    }
+
+    return state;
+}
+
+void chip8::LockstepCpu::restore(const size_t lane, const LaneState& state, const uint64_t seed)
+{
+    for (size_t index = 0; index < state.V.size(); index++)
+    {
+        V[index * stride + lane] = state.V[index];
+    }
+
+    I[lane] = state.I;
+    PC[lane] = state.PC;
+    SP[lane] = state.SP;
+    for (size_t index = 0; index < StackSize; index++)
+    {
+        stack[index * stride + lane] = state.stack[index];
+    }
+
+    delayTimer[lane] = state.delayTimer;
+    soundTimer[lane] = state.soundTimer;
+    std::copy(state.frameBuffer.begin(), state.frameBuffer.end(), frameBuffers.begin() + lane * chip8::Gpu::Height);
+
+    keys[lane] = 0;
+    budget[lane] = 0;
+    waitingForKey[lane] = 0;
+    errors[lane] = std::nullopt;
+    randomGenerators[lane] = chip8::RandomGenerator(chip8::RandomEngine::Xorshift, seed);
+
+    for (size_t page = 0; page < Pages; page++)
+    {
+        const uint8_t* statePage = state.memory.data() + page * PageSize;
+        if (std::equal(statePage, statePage + PageSize, image.begin() + page * PageSize))
+        {
+            share(lane, page);
+        }
+        else if (!std::equal(statePage, statePage + PageSize, pageTable[lane * Pages + page]))
+        {
+            // The first write copies the page, the others write the copy.
+            for (size_t offset = 0; offset < PageSize; offset++)
+            {
+                write(lane, static_cast<uint16_t>(page * PageSize + offset), statePage[offset]);
+            }
+        }
+    }
+}
+
+size_t chip8::LockstepCpu::getLaneCount() const
+{
+    return lanes;
+}
+
+bool chip8::LockstepCpu::isWaitingForKey(const size_t lane) const
+{
+    return waitingForKey[lane] != 0;
+}
+
+std::optional<chip8::CpuErrorCode> chip8::LockstepCpu::getError(const size_t lane) const
+{
+    return errors[lane];
+}
+
+bool chip8::LockstepCpu::shouldPlayAudio(const size_t lane) const
+{
+    return soundTimer[lane] > 0;
+}
+
+std::span<const uint64_t> chip8::LockstepCpu::getFrameBuffer(const size_t lane) const
+{
+    return std::span<const uint64_t>(frameBuffers).subspan(lane * chip8::Gpu::Height, chip8::Gpu::Height);
+}
+
+std::span<const uint64_t> chip8::LockstepCpu::getFrameBuffers() const
+{
+    return frameBuffers;
+}
+
+uint8_t chip8::LockstepCpu::getV(const size_t lane, const size_t index) const
+{
+    return V[index * stride + lane];
+}
+
+uint16_t chip8::LockstepCpu::getI(const size_t lane) const
+{
+    return I[lane];
+}
+
+uint16_t chip8::LockstepCpu::getPC(const size_t lane) const
+{
+    return PC[lane];
+}
+
+uint8_t chip8::LockstepCpu::getSP(const size_t lane) const
+{
+    return SP[lane];
+}
+
+uint8_t chip8::LockstepCpu::getDelayTimer(const size_t lane) const
+{
+    return delayTimer[lane];
+}
+
+uint8_t chip8::LockstepCpu::getSoundTimer(const size_t lane) const
+{
+    return soundTimer[lane];
+}
+
+uint8_t chip8::LockstepCpu::readMemory(const size_t lane, const uint16_t address) const
+{
+    return read(lane, address);
+}
+
+size_t chip8::LockstepCpu::getPrivatePageCount() const
+{
+    return privatePages.size() - freePages.size();
+}
+
+// Executes the instruction at the lowest PC on the lanes at that PC, which advance to the next instruction first as in Cpu::step. Returns
+// the number of these lanes, 0 once no lane has any budget left.
+size_t chip8::LockstepCpu::step()
+{
+    uint16_t groupPC = NoPC;
+    size_t leader = 0;
+    size_t count = level == chip8::SimdLevel::Avx2 ? selectGroupAvx2(groupPC, leader) : selectGroupScalar(groupPC, leader);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (privateCopies[groupPC / PageSize] != 0 || privateCopies[(groupPC + 1) % MemorySize / PageSize] != 0)
+    {
+        count = excludeModifiedCode(groupPC, leader, count);
+    }
+
+    const uint8_t byte1 = read(leader, groupPC);
+    const uint8_t byte2 = read(leader, groupPC + 1);
+
+    if (level == chip8::SimdLevel::Avx2 && executeAvx2(byte1, byte2))
+    {
+        return count;
+    }
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        if (group[lane] != 0)
+        {
+            execute(lane, byte1, byte2);
+        }
+    }
+
+    return count;
+}
+
+// Selects the lanes with budget left at the lowest PC, the first of them being the leader, and moves them to the next instruction.
+size_t chip8::LockstepCpu::selectGroupScalar(uint16_t& groupPC, size_t& leader)
+{
+    groupPC = NoPC;
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        if (budget[lane] != 0 && PC[lane] < groupPC)
+        {
+            groupPC = PC[lane];
+        }
+    }
+
+    if (groupPC == NoPC)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        const bool selected = budget[lane] != 0 && PC[lane] == groupPC;
+        group[lane] = selected ? 0xFF : 0;
+
+        if (selected)
+        {
+            leader = count == 0 ? lane : leader;
+            PC[lane] = static_cast<uint16_t>((PC[lane] + 2) % MemorySize);
+            budget[lane]--;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+#ifdef CHIP8_AVX2_SUPPORTED
+// Same as selectGroupScalar, 16 lanes at a time. Lanes without budget are given NoPC, which is above any address, to find the lowest PC.
+CHIP8_TARGET_AVX2 size_t chip8::LockstepCpu::selectGroupAvx2(uint16_t& groupPC, size_t& leader)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lowestPC = _mm256_set1_epi16(static_cast<short>(NoPC));
+
+    for (size_t lane = 0; lane < stride; lane += 16)
+    {
+        const __m256i idle = _mm256_cmpeq_epi16(load(budget.data() + lane), zero);
+        lowestPC = _mm256_min_epu16(lowestPC, _mm256_or_si256(load(PC.data() + lane), idle));
+    }
+
+    const __m128i halves = _mm_min_epu16(_mm256_castsi256_si128(lowestPC), _mm256_extracti128_si256(lowestPC, 1));
+    groupPC = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(halves)));
+
+    if (groupPC == NoPC)
+    {
+        return 0;
+    }
+
+    const __m256i target = _mm256_set1_epi16(static_cast<short>(groupPC));
+    const __m256i instructionSize = _mm256_set1_epi16(2);
+    const __m256i addressMask = _mm256_set1_epi16(static_cast<short>(MemorySize - 1));
+    size_t count = 0;
+
+    for (size_t lane = 0; lane < stride; lane += 32)
+    {
+        __m256i selected[2];
+        for (size_t half = 0; half < 2; half++)
+        {
+            uint16_t* const lanePC = PC.data() + lane + 16 * half;
+            uint16_t* const laneBudget = budget.data() + lane + 16 * half;
+            const __m256i budgets = load(laneBudget);
+            const __m256i PCs = load(lanePC);
+
+            selected[half] = _mm256_andnot_si256(_mm256_cmpeq_epi16(budgets, zero), _mm256_cmpeq_epi16(PCs, target));
+            const __m256i nextPCs = _mm256_and_si256(_mm256_add_epi16(PCs, _mm256_and_si256(selected[half], instructionSize)), addressMask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanePC), nextPCs);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(laneBudget), _mm256_add_epi16(budgets, selected[half]));
+        }
+
+        // Packing interleaves the 128-bit halves of its operands: the permutation puts the lanes back in order.
+        const __m256i selectedBytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(selected[0], selected[1]), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(group.data() + lane), selectedBytes);
+
+        const uint32_t selectedLanes = static_cast<uint32_t>(_mm256_movemask_epi8(selectedBytes));
+        if (count == 0 && selectedLanes != 0)
+        {
+            leader = lane + std::countr_zero(selectedLanes);
+        }
+        count += std::popcount(selectedLanes);
+    }
+
+    return count;
+}
+
+// Instructions that only read and write registers and timers, executed on 32 lanes at a time (16 for 16-bit registers). Returns false for
+// the other instructions, executed lane by lane. Stores Vx and VF in the order of the interpreter (see execute_add_vx_vy in Cpu.cpp): shifts
+// load Vx again after storing VF, as that store overwrote it when x is F.
+CHIP8_TARGET_AVX2 bool chip8::LockstepCpu::executeAvx2(const uint8_t byte1, const uint8_t byte2)
+{
+    const binding::Operands operands = binding::Operands::decode(byte1, byte2);
+    const uint8_t opcode = byte1 >> 4;
+    uint8_t* const Vx = V.data() + operands.x * stride;
+    uint8_t* const Vy = V.data() + operands.y * stride;
+    uint8_t* const Vf = V.data() + VF * stride;
+    const __m256i one = _mm256_set1_epi8(1);
+
+    switch (opcode)
+    {
+    case 0x1:
+    case 0xA:
+    {
+        uint16_t* const pointer = opcode == 0x1 ? PC.data() : I.data();
+        const __m256i address = _mm256_set1_epi16(static_cast<short>(operands.nnn));
+        for (size_t lane = 0; lane < stride; lane += 16)
+        {
+            storeSelected(pointer + lane, address, loadWidened(group.data() + lane));
+        }
+        return true;
+    }
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+    {
+        if ((opcode == 0x5 || opcode == 0x9) && operands.n != 0)
+        {
+            return false;
+        }
+
+        const __m256i byte = _mm256_set1_epi8(static_cast<char>(operands.kk));
+        const __m256i skipSize = _mm256_set1_epi16(2);
+        const __m256i addressMask = _mm256_set1_epi16(static_cast<short>(MemorySize - 1));
+        std::array<uint8_t, 32> skipped;
+
+        for (size_t lane = 0; lane < stride; lane += 32)
+        {
+            const __m256i equal = _mm256_cmpeq_epi8(load(Vx + lane), opcode == 0x3 || opcode == 0x4 ? byte : load(Vy + lane));
+            const __m256i skip = opcode == 0x3 || opcode == 0x5 ? equal : _mm256_xor_si256(equal, _mm256_set1_epi8(-1));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(skipped.data()), _mm256_and_si256(skip, load(group.data() + lane)));
+
+            for (size_t half = 0; half < 2; half++)
+            {
+                uint16_t* const lanePC = PC.data() + lane + 16 * half;
+                const __m256i increment = _mm256_and_si256(loadWidened(skipped.data() + 16 * half), skipSize);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanePC), _mm256_and_si256(_mm256_add_epi16(load(lanePC), increment), addressMask));
+            }
+        }
+        return true;
+    }
+    case 0x6:
+    case 0x7:
+    {
+        const __m256i byte = _mm256_set1_epi8(static_cast<char>(operands.kk));
+        for (size_t lane = 0; lane < stride; lane += 32)
+        {
+            const __m256i value = opcode == 0x6 ? byte : _mm256_add_epi8(load(Vx + lane), byte);
+            storeSelected(Vx + lane, value, load(group.data() + lane));
+        }
+        return true;
+    }
+    case 0x8:
+        if (operands.n > 0x7 && operands.n != 0xE)
+        {
+            return false;
+        }
+
+        for (size_t lane = 0; lane < stride; lane += 32)
+        {
+            const __m256i selected = load(group.data() + lane);
+            const __m256i x = load(Vx + lane);
+            const __m256i y = load(Vy + lane);
+
+            switch (operands.n)
+            {
+            case 0x0:
+                storeSelected(Vx + lane, y, selected);
+                break;
+            case 0x1:
+                storeSelected(Vx + lane, _mm256_or_si256(x, y), selected);
+                break;
+            case 0x2:
+                storeSelected(Vx + lane, _mm256_and_si256(x, y), selected);
+                break;
+            case 0x3:
+                storeSelected(Vx + lane, _mm256_xor_si256(x, y), selected);
+                break;
+            case 0x4:
+            {
+                // Carry if the sum is below Vx.
+                const __m256i sum = _mm256_add_epi8(x, y);
+                storeSelected(Vx + lane, sum, selected);
+                storeSelected(Vf + lane, toFlag(_mm256_andnot_si256(_mm256_cmpeq_epi8(sum, x), lessOrEqual(sum, x))), selected);
+                break;
+            }
+            case 0x5:
+            {
+                const __m256i difference = _mm256_sub_epi8(x, y);
+                storeSelected(Vx + lane, difference, selected);
+                storeSelected(Vf + lane, toFlag(lessOrEqual(difference, x)), selected);
+                break;
+            }
+            case 0x6:
+                storeSelected(Vf + lane, _mm256_and_si256(x, one), selected);
+                storeSelected(Vx + lane, _mm256_and_si256(_mm256_srli_epi16(load(Vx + lane), 1), _mm256_set1_epi8(0x7F)), selected);
+                break;
+            case 0x7:
+            {
+                const __m256i difference = _mm256_sub_epi8(y, x);
+                storeSelected(Vx + lane, difference, selected);
+                storeSelected(Vf + lane, toFlag(lessOrEqual(difference, y)), selected);
+                break;
+            }
+            case 0xE:
+            {
+                storeSelected(Vf + lane, _mm256_and_si256(_mm256_srli_epi16(x, 7), one), selected);
+                const __m256i shifted = load(Vx + lane);
+                storeSelected(Vx + lane, _mm256_add_epi8(shifted, shifted), selected);
+                break;
+            }
+            }
+        }
+        return true;
+    case 0xF:
+        switch (byte2)
+        {
+        case 0x07:
+        case 0x15:
+        case 0x18:
+        {
+            const uint8_t* const source = byte2 == 0x07 ? delayTimer.data() : Vx;
+            uint8_t* const destination = byte2 == 0x07 ? Vx : byte2 == 0x15 ? delayTimer.data() : soundTimer.data();
+            for (size_t lane = 0; lane < stride; lane += 32)
+            {
+                storeSelected(destination + lane, load(source + lane), load(group.data() + lane));
+            }
+            return true;
+        }
+        case 0x1E:
+        case 0x29:
+        {
+            const __m256i addressMask = _mm256_set1_epi16(static_cast<short>(MemorySize - 1));
+            const __m256i characterHeight = _mm256_set1_epi16(static_cast<short>(chip8::FontCharacterHeight));
+            for (size_t lane = 0; lane < stride; lane += 16)
+            {
+                const __m256i x = loadExtended(Vx + lane);
+                const __m256i address = byte2 == 0x1E ? _mm256_and_si256(_mm256_add_epi16(load(I.data() + lane), x), addressMask)
+                                                      : _mm256_mullo_epi16(x, characterHeight);
+                storeSelected(I.data() + lane, address, loadWidened(group.data() + lane));
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    default:
+        return false;
+    }
+}
+#else
+size_t chip8::LockstepCpu::selectGroupAvx2(uint16_t& groupPC, size_t& leader)
+{
+    return selectGroupScalar(groupPC, leader);
+}
+
+bool chip8::LockstepCpu::executeAvx2(const uint8_t byte1, const uint8_t byte2)
+{
+    return false;
+}
+#endif
+
+// Lanes that overwrote the instruction at PC may not execute the leader's: they are left out of the group, to run in another one.
+size_t chip8::LockstepCpu::excludeModifiedCode(const uint16_t groupPC, const size_t leader, size_t count)
+{
+    const uint8_t byte1 = read(leader, groupPC);
+    const uint8_t byte2 = read(leader, groupPC + 1);
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        if (group[lane] != 0 && (read(lane, groupPC) != byte1 || read(lane, groupPC + 1) != byte2))
+        {
+            group[lane] = 0;
+            PC[lane] = groupPC;
+            budget[lane]++;
+            count--;
+        }
+    }
+
+    return count;
+}
+
+// Executes the instruction on a single lane, as Cpu with WrappedBounds does.
+void chip8::LockstepCpu::execute(const size_t lane, const uint8_t byte1, const uint8_t byte2)
+{
+    const binding::Operands operands = binding::Operands::decode(byte1, byte2);
+    uint8_t& Vx = V[operands.x * stride + lane];
+    uint8_t& Vy = V[operands.y * stride + lane];
+    uint8_t& Vf = V[VF * stride + lane];
+    uint16_t& laneI = I[lane];
+    uint16_t& lanePC = PC[lane];
+    uint8_t& laneSP = SP[lane];
+
+    switch (byte1 >> 4)
+    {
+    case 0x0:
+        if (byte1 == 0x00 && byte2 == 0xE0)
+        {
+            const std::span<uint64_t, chip8::Gpu::Height> frameBuffer = getLaneFrameBuffer(lane);
+            std::fill(frameBuffer.begin(), frameBuffer.end(), 0);
+        }
+        else if (byte1 == 0x00 && byte2 == 0xEE)
+        {
+            const uint8_t returnByte2 = stack[(laneSP - 1) % StackSize * stride + lane];
+            const uint8_t returnByte1 = stack[(laneSP - 2) % StackSize * stride + lane];
+            lanePC = static_cast<uint16_t>(((returnByte1 << 8) | returnByte2) % MemorySize);
+            laneSP = static_cast<uint8_t>((laneSP - 2) % StackSize);
+        }
+        else
+        {
+            stop(lane, CpuErrorCode::UnsupportedSysInstruction);
+        }
+        break;
+    case 0x1:
+        lanePC = operands.nnn;
+        break;
+    case 0x2:
+        stack[(laneSP + 1) % StackSize * stride + lane] = static_cast<uint8_t>(lanePC & 0x00FF);
+        stack[laneSP * stride + lane] = static_cast<uint8_t>((lanePC & 0xFF00) >> 8);
+        laneSP = static_cast<uint8_t>((laneSP + 2) % StackSize);
+        lanePC = operands.nnn;
+        break;
+    case 0x3:
+        lanePC = static_cast<uint16_t>((lanePC + (Vx == operands.kk ? 2 : 0)) % MemorySize);
+        break;
+    case 0x4:
+        lanePC = static_cast<uint16_t>((lanePC + (Vx != operands.kk ? 2 : 0)) % MemorySize);
+        break;
+    case 0x5:
+    case 0x9:
+        if (operands.n != 0)
+        {
+            stop(lane, CpuErrorCode::UnmatchedInstruction);
+            break;
+        }
+        lanePC = static_cast<uint16_t>((lanePC + ((Vx == Vy) == (byte1 >> 4 == 0x5) ? 2 : 0)) % MemorySize);
+        break;
+    case 0x6:
+        Vx = operands.kk;
+        break;
+    case 0x7:
+        Vx = static_cast<uint8_t>(Vx + operands.kk);
+        break;
+    case 0x8:
+        switch (operands.n)
+        {
+        case 0x0:
+            Vx = Vy;
+            break;
+        case 0x1:
+            Vx |= Vy;
+            break;
+        case 0x2:
+            Vx &= Vy;
+            break;
+        case 0x3:
+            Vx ^= Vy;
+            break;
+        case 0x4:
+        {
+            const uint8_t original = Vx;
+            Vx = static_cast<uint8_t>(Vx + Vy);
+            Vf = Vx < original;
+            break;
+        }
+        case 0x5:
+        {
+            const uint8_t original = Vx;
+            Vx = static_cast<uint8_t>(Vx - Vy);
+            Vf = Vx <= original;
+            break;
+        }
+        case 0x6:
+            Vf = Vx & 1;
+            Vx = Vx >> 1;
+            break;
+        case 0x7:
+        {
+            const uint8_t original = Vy;
+            Vx = static_cast<uint8_t>(Vy - Vx);
+            Vf = Vx <= original;
+            break;
+        }
+        case 0xE:
+            Vf = (Vx & 0x80) == 0x80;
+            Vx = static_cast<uint8_t>(Vx << 1);
+            break;
+        default:
+            stop(lane, CpuErrorCode::UnmatchedInstruction);
+            break;
+        }
+        break;
+    case 0xA:
+        laneI = operands.nnn;
+        break;
+    case 0xB:
+        lanePC = static_cast<uint16_t>((V[lane] + operands.nnn) % MemorySize);
+        break;
+    case 0xC:
+        Vx = randomGenerators[lane].next() & operands.kk;
+        break;
+    case 0xD:
+    {
+        std::array<uint8_t, 15> sprite;
+        for (size_t i = 0; i < operands.n; i++)
+        {
+            sprite[i] = read(lane, static_cast<uint16_t>(laneI + i));
+        }
+        uint32_t drawnRows = 0;
+        Vf = chip8::Gpu::drawSprite(getLaneFrameBuffer(lane), Vx, Vy, std::span<const uint8_t>(sprite.data(), operands.n), drawnRows);
+        break;
+    }
+    case 0xE:
+        if (byte2 != 0x9E && byte2 != 0xA1)
+        {
+            stop(lane, CpuErrorCode::UnmatchedInstruction);
+        }
+        else if (Vx >= 16)
+        {
+            stop(lane, CpuErrorCode::BadKeyboardIndex);
+        }
+        else if (((keys[lane] >> Vx & 1) != 0) == (byte2 == 0x9E))
+        {
+            lanePC = static_cast<uint16_t>((lanePC + 2) % MemorySize);
+        }
+        break;
+    case 0xF:
+        switch (byte2)
+        {
+        case 0x07:
+            Vx = delayTimer[lane];
+            break;
+        case 0x0A:
+            if (keys[lane] != 0)
+            {
+                const int key = std::countr_zero(keys[lane]);
+                Vx = static_cast<uint8_t>(key);
+                keys[lane] &= static_cast<uint16_t>(~(1 << key));
+            }
+            else
+            {
+                // Try again on the next run.
+                lanePC = static_cast<uint16_t>((lanePC - 2) % MemorySize);
+                waitingForKey[lane] = 1;
+                budget[lane] = 0;
+            }
+            break;
+        case 0x15:
+            delayTimer[lane] = Vx;
+            break;
+        case 0x18:
+            soundTimer[lane] = Vx;
+            break;
+        case 0x1E:
+            laneI = static_cast<uint16_t>((laneI + Vx) % MemorySize);
+            break;
+        case 0x29:
+            laneI = static_cast<uint16_t>(Vx * chip8::FontCharacterHeight);
+            break;
+        case 0x33:
+            write(lane, laneI, Vx / 100);
+            write(lane, laneI + 1, (Vx / 10) % 10);
+            write(lane, laneI + 2, Vx % 10);
+            break;
+        case 0x55:
+            for (size_t i = 0; i <= operands.x; i++)
+            {
+                write(lane, laneI, V[i * stride + lane]);
+                laneI = static_cast<uint16_t>((laneI + 1) % MemorySize);
+            }
+            break;
+        case 0x65:
+            for (size_t i = 0; i <= operands.x; i++)
+            {
+                V[i * stride + lane] = read(lane, laneI);
+                laneI = static_cast<uint16_t>((laneI + 1) % MemorySize);
+            }
+            break;
+        default:
+            stop(lane, CpuErrorCode::UnmatchedInstruction);
+            break;
+        }
+        break;
+    }
+}
+
+void chip8::LockstepCpu::stop(const size_t lane, const chip8::CpuErrorCode errorCode)
+{
+    errors[lane] = errorCode;
+    budget[lane] = 0;
+    logger.logDebug("Lane %zu stopped: %s", lane, chip8::CpuExecutionException(errorCode).what());
+}
+
+uint8_t chip8::LockstepCpu::read(const size_t lane, const uint16_t address) const
+{
+    const size_t wrappedAddress = address % MemorySize;
+    return pageTable[lane * Pages + wrappedAddress / PageSize][wrappedAddress % PageSize];
+}
+
+// Copies the page on the lane's first write to it.
+void chip8::LockstepCpu::write(const size_t lane, const uint16_t address, const uint8_t value)
+{
+    const size_t wrappedAddress = address % MemorySize;
+    const size_t page = wrappedAddress / PageSize;
+    uint8_t*& pageData = pageTable[lane * Pages + page];
+
+    if (!isPrivate(lane, page))
+    {
+        if (freePages.empty())
+        {
+            privatePages.push_back(std::make_unique<Page>());
+            freePages.push_back(privatePages.back()->data());
+        }
+
+        uint8_t* const copy = freePages.back();
+        freePages.pop_back();
+        std::copy(pageData, pageData + PageSize, copy);
+        pageData = copy;
+        privateCopies[page]++;
+    }
+
+    pageData[wrappedAddress % PageSize] = value;
+}
+
+bool chip8::LockstepCpu::isPrivate(const size_t lane, const size_t page) const
+{
+    return pageTable[lane * Pages + page] != image.data() + page * PageSize;
+}
+
+// Points the lane back to the image, freeing its private copy of the page if any.
+void chip8::LockstepCpu::share(const size_t lane, const size_t page)
+{
+    if (isPrivate(lane, page))
+    {
+        freePages.push_back(pageTable[lane * Pages + page]);
+        pageTable[lane * Pages + page] = image.data() + page * PageSize;
+        privateCopies[page]--;
+    }
+}
+
+std::span<uint64_t, chip8::Gpu::Height> chip8::LockstepCpu::getLaneFrameBuffer(const size_t lane)
+{
+    return std::span<uint64_t, chip8::Gpu::Height>(frameBuffers.data() + lane * chip8::Gpu::Height, chip8::Gpu::Height);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cpu/Registers.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8
+{
+    // Whether the native backends, JitCompiler and the ahead-of-time RomTranslator, support the instruction made of byte1 and byte2 at
+    // address: those that can neither throw, wait nor access anything but V, I, PC and (reading it) the delay timer.
+    inline bool isNativeInstruction(const uint8_t byte1, const uint8_t byte2, const uint16_t address)
+    {
+        switch (byte1 >> 4)
+        {
+        case 0x1:
+        case 0x6:
+        case 0x7:
+        case 0xA:
+            return true;
+        case 0x3:
+        case 0x4:
+            return static_cast<size_t>(address) + 4 <= chip8::Registers::MemorySize; // Skipping must not move PC out of memory
+        case 0x5:
+        case 0x9:
+            return (byte2 & 0x0F) == 0 && static_cast<size_t>(address) + 4 <= chip8::Registers::MemorySize;
+        case 0x8:
+            return (byte2 & 0x0F) <= 0x7 || (byte2 & 0x0F) == 0xE;
+        case 0xF:
+            return byte2 == 0x07;
+        default:
+            return false;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "cpu/RandomGenerator.hpp"
+
+#include <stdexcept>
+
+namespace
+{
+    // splitmix64, so that close seeds (0, 1, 2...) give unrelated sequences and no seed gives the all-zero state xorshift cannot leave.
+    uint64_t mix(uint64_t seed)
+    {
+        seed += 0x9E3779B97F4A7C15;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EB;
+        seed ^= seed >> 31;
+        return seed != 0 ? seed : 1;
+    }
+}
+
+chip8::RandomGenerator::RandomGenerator(const chip8::RandomEngine engine, const uint64_t seed)
+    : state(mix(seed))
+    , standardEngine(engine == chip8::RandomEngine::Standard ? std::make_unique<std::default_random_engine>(
+                                                                   static_cast<std::default_random_engine::result_type>(seed))
+                                                             : nullptr)
+{
+}
+
+uint64_t chip8::RandomGenerator::createRandomSeed()
+{
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+uint8_t chip8::RandomGenerator::next()
+{
+    if (standardEngine)
+    {
+        // Not uniform_int_distribution<uint8_t>: the effect is undefined for that type (see C++ specifications).
+        std::uniform_int_distribution<unsigned> distribution(0, 0xFF);
+        return static_cast<uint8_t>(distribution(*standardEngine));
+    }
+
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return static_cast<uint8_t>((state * 0x2545F4914F6CDD1D) >> 56);
+}
+
+uint64_t chip8::RandomGenerator::getState() const
+{
+    if (standardEngine)
+    {
+        throw std::logic_error("The state of the standard random engine cannot be saved");
+    }
+
+    return state;
+}
+
+void chip8::RandomGenerator::setState(const uint64_t state)
+{
+    if (standardEngine)
+    {
+        throw std::logic_error("The state of the standard random engine cannot be restored");
+    }
+
+    // Xorshift never leaves the all-zero state.
+    this->state = state != 0 ? state : 1;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHIP8_SSE2_SUPPORTED
+#include <immintrin.h>
+#endif
+
+// GCC and Clang compile the AVX2 code for hosts that support it whatever the build flags, other compilers only if it is enabled.
+#if defined(CHIP8_SSE2_SUPPORTED) && (defined(__GNUC__) || defined(__AVX2__))
+#define CHIP8_AVX2_SUPPORTED
+#endif
+
+#if defined(CHIP8_AVX2_SUPPORTED) && defined(__GNUC__)
+#define CHIP8_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHIP8_TARGET_AVX2
+#endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "cpu/SimdLevel.hpp"
+
+#include "Simd.hpp"
+
+namespace
+{
+    chip8::SimdLevel detectSimdLevel()
+    {
+#if defined(CHIP8_AVX2_SUPPORTED) && defined(__GNUC__)
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return chip8::SimdLevel::Avx2;
+        }
+#elif defined(CHIP8_AVX2_SUPPORTED)
+        return chip8::SimdLevel::Avx2;
+#endif
+
+#ifdef CHIP8_SSE2_SUPPORTED
+        return chip8::SimdLevel::Sse2;
+#else
+        return chip8::SimdLevel::None;
+#endif
+    }
+}
+
+chip8::SimdLevel chip8::getSimdLevel()
+{
+    static const chip8::SimdLevel level = detectSimdLevel();
+    return level;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "cpu/Timer.hpp"
 
+#include <algorithm>
+
 void chip8::Timer::setValue(const uint8_t value)
 {
     counter = value;
@@ -10,18 +12,18 @@ uint8_t chip8::Timer::getValue() const
     return counter;
 }
 
+// The clock is monotonic, so that changing the system time does not affect timers.
 void chip8::Timer::updateValue()
 {
-    auto millisecondsSinceLatestDecrement =
-        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - latestCounterDecrement).count();
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t millisecondsSinceLatestDecrement = std::chrono::duration_cast<std::chrono::milliseconds>(now - latestCounterDecrement).count();
 
     if (millisecondsSinceLatestDecrement >= TickPeriod)
     {
-        if (counter > 0)
-        {
-            counter -= millisecondsSinceLatestDecrement / TickPeriod;
-        }
+        const uint64_t ticks = millisecondsSinceLatestDecrement / TickPeriod;
+        counter -= static_cast<uint8_t>(std::min<uint64_t>(counter, ticks));
 
-        latestCounterDecrement = std::chrono::system_clock::now();
+        // Keep the time elapsed since the latest tick, so that ticks do not drift.
+        latestCounterDecrement += std::chrono::milliseconds(ticks * TickPeriod);
     }
 }
\ No newline at end of file
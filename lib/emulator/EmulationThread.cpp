@@ -0,0 +1,174 @@
+#include "EmulationThread.hpp"
+
+#include <algorithm>
+#include <emulator/FramePacer.hpp>
+
+template <typename CpuType>
+chip8::EmulationThread<CpuType>::EmulationThread(const logging::Logger& logger,
+                                                 CpuType& cpu,
+                                                 chip8::FrameClock& frameClock,
+                                                 const uint32_t instructionsPerSecond,
+                                                 const chip8::OverrunPolicy overrunPolicy,
+                                                 std::function<void()> onUpdate)
+    : logger(logger)
+    , cpu(cpu)
+    , frameClock(frameClock)
+    , instructionsPerSecond(instructionsPerSecond)
+    , overrunPolicy(overrunPolicy)
+    , onUpdate(std::move(onUpdate))
+    , running(false)
+    , failed(false)
+    , heldKeys(0)
+    , pressedKeys(0)
+    , cpuKeys(0)
+    , playAudio(false)
+{
+}
+
+template <typename CpuType>
+chip8::EmulationThread<CpuType>::~EmulationThread()
+{
+    stop();
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::start()
+{
+    running = true;
+    thread = std::thread(&EmulationThread::run, this);
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::stop()
+{
+    running = false;
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::onKeyPressed(const chip8::Key key)
+{
+    const uint16_t bit = static_cast<uint16_t>(1 << static_cast<size_t>(key));
+    heldKeys.fetch_or(bit);
+    pressedKeys.fetch_or(bit);
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::onKeyReleased(const chip8::Key key)
+{
+    heldKeys.fetch_and(static_cast<uint16_t>(~(1 << static_cast<size_t>(key))));
+}
+
+template <typename CpuType>
+bool chip8::EmulationThread<CpuType>::shouldPlayAudio() const
+{
+    return playAudio;
+}
+
+template <typename CpuType>
+const typename chip8::EmulationThread<CpuType>::Frame* chip8::EmulationThread<CpuType>::takeFrame()
+{
+    return frames.read();
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::rethrowError() const
+{
+    // error is written before failed is set.
+    if (failed)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::run()
+{
+    chip8::FramePacer pacer(instructionsPerSecond, overrunPolicy);
+
+    try
+    {
+        while (running)
+        {
+            const uint64_t executedInstructions = runFrame(pacer.getFrameInstructions());
+            chip8::FramePacer::waitUntil(pacer.onFrameExecuted(executedInstructions));
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+        failed = true;
+        running = false;
+        onUpdate();
+    }
+
+    // Fewer instructions than requested are executed while the program waits for a key.
+    logger.logInfo("Requested %u instructions/s, executed %.0f instructions/s, %llu frames dropped",
+                   pacer.getRequestedRate(),
+                   pacer.getAchievedRate(),
+                   static_cast<unsigned long long>(pacer.getDroppedFrames()));
+}
+
+template <typename CpuType>
+uint64_t chip8::EmulationThread<CpuType>::runFrame(const uint32_t instructions)
+{
+    updateKeys();
+
+    const chip8::RunResult result = cpu.run(instructions);
+    frameClock.tick();
+
+    bool updated = false;
+    if (result.audioChanged)
+    {
+        playAudio = cpu.shouldPlayAudio();
+        updated = true;
+    }
+
+    if (result.frameDirty)
+    {
+        // Frames that look the same as the one published last, e.g. when a sprite was drawn then erased, are not published.
+        if (cpu.getDirtyRows() != 0)
+        {
+            const std::span<const uint64_t> frameBuffer = cpu.getFrameBuffer();
+            std::copy(frameBuffer.begin(), frameBuffer.end(), frames.getWriteBuffer().begin());
+            frames.publish();
+            updated = true;
+        }
+
+        cpu.onDrawComplete();
+    }
+
+    if (updated)
+    {
+        onUpdate();
+    }
+
+    return result.instructions;
+}
+
+template <typename CpuType>
+void chip8::EmulationThread<CpuType>::updateKeys()
+{
+    const uint16_t keys = heldKeys | pressedKeys.exchange(0);
+
+    for (size_t key = 0; key < 16; key++)
+    {
+        const uint16_t bit = static_cast<uint16_t>(1 << key);
+        if ((keys & bit) != 0 && (cpuKeys & bit) == 0)
+        {
+            cpu.onKeyPressed(static_cast<chip8::Key>(key));
+        }
+        else if ((keys & bit) == 0 && (cpuKeys & bit) != 0)
+        {
+            cpu.onKeyReleased(static_cast<chip8::Key>(key));
+        }
+    }
+
+    cpuKeys = keys;
+}
+
+template class chip8::EmulationThread<chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>>;
+template class chip8::EmulationThread<chip8::BasicCpu<chip8::Gpu, chip8::Timer>>;
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cpu/Cpu.hpp>
+#include <cpu/FrameClock.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/Key.hpp>
+#include <cpu/Timer.hpp>
+#include <emulator/OverrunPolicy.hpp>
+#include <emulator/TripleBuffer.hpp>
+#include <exception>
+#include <functional>
+#include <thread>
+
+#include "logging/Logger.hpp"
+
+namespace chip8
+{
+    // Runs a CpuType (a chip8::BasicCpu) on its own thread, one frame of instructions at a time at 60 Hz (see FramePacer), so that the
+    // thread handling the window only deals with input and presentation. Frames are handed over through a triple buffer and keys through
+    // atomics.
+    template <typename CpuType>
+    class EmulationThread
+    {
+      public:
+        using Frame = std::array<uint64_t, chip8::Gpu::Height>;
+
+        // onUpdate is called from the emulation thread when a new frame is published, when shouldPlayAudio changes and when the thread
+        // stops on an error.
+        EmulationThread(const logging::Logger& logger,
+                        CpuType& cpu,
+                        chip8::FrameClock& frameClock,
+                        const uint32_t instructionsPerSecond,
+                        const chip8::OverrunPolicy overrunPolicy,
+                        std::function<void()> onUpdate);
+        ~EmulationThread();
+
+        void start();
+        void stop();
+
+        void onKeyPressed(const chip8::Key key);
+        void onKeyReleased(const chip8::Key key);
+        bool shouldPlayAudio() const;
+
+        // Latest frame published since the last call, or nullptr. Must be called from a single thread.
+        const Frame* takeFrame();
+
+        // Rethrows the error that stopped the emulation, if any.
+        void rethrowError() const;
+
+        EmulationThread(const EmulationThread&) = delete;
+        EmulationThread& operator=(const EmulationThread&) = delete;
+
+      private:
+        void run();
+        uint64_t runFrame(const uint32_t instructions);
+        void updateKeys();
+
+      private:
+        const logging::Logger& logger;
+        CpuType& cpu;
+        chip8::FrameClock& frameClock;
+        const uint32_t instructionsPerSecond;
+        const chip8::OverrunPolicy overrunPolicy;
+        const std::function<void()> onUpdate;
+
+        std::thread thread;
+        std::atomic<bool> running;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+
+        // One bit per key: held keys, and keys pressed since the emulation thread last read them, so that a key pressed and released
+        // within a frame is still seen by the CPU.
+        std::atomic<uint16_t> heldKeys;
+        std::atomic<uint16_t> pressedKeys;
+        uint16_t cpuKeys; // Keys pressed as far as the CPU knows, only used by the emulation thread
+
+        std::atomic<bool> playAudio;
+        chip8::TripleBuffer<Frame> frames;
+    };
+
+    extern template class EmulationThread<chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>>;
+    extern template class EmulationThread<chip8::BasicCpu<chip8::Gpu, chip8::Timer>>;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <SDL.h>
 #include <cpu/Cpu.hpp>
+#include <cpu/FrameTimer.hpp>
 #include <cpu/Gpu.hpp>
 #include <cpu/RomLoadFailureException.hpp>
 #include <cpu/Timer.hpp>
@@ -29,17 +30,60 @@ chip8::Emulator::~Emulator()
 
 #include "AudioController.hpp"
 
-void chip8::Emulator::run(const std::string& programName, const std::string& version, const uint32_t clock)
+void chip8::Emulator::run(const std::string& programName,
+                          const std::string& version,
+                          const uint32_t clock,
+                          const chip8::OverrunPolicy overrunPolicy,
+                          const chip8::ExecutionEngine engine,
+                          const chip8::TimerMode timerMode,
+                          const chip8::DisplayMode displayMode,
+                          const chip8::RandomEngine randomEngine,
+                          const uint64_t seed,
+                          const chip8::Palette& palette)
 {
+    chip8::FrameClock frameClock;
+    chip8::RandomGenerator randomGenerator(randomEngine, seed);
+
+    if (timerMode == chip8::TimerMode::WallClock)
+    {
+        chip8::Timer soundTimer;
+        chip8::Timer delayTimer;
+        runCpu(programName, version, clock, overrunPolicy, engine, displayMode, std::move(randomGenerator), palette, frameClock, soundTimer, delayTimer);
+        return;
+    }
+
+    chip8::FrameTimer soundTimer(frameClock);
+    chip8::FrameTimer delayTimer(frameClock);
+    runCpu(programName, version, clock, overrunPolicy, engine, displayMode, std::move(randomGenerator), palette, frameClock, soundTimer, delayTimer);
+}
+
+// The CPU is specialized on the timers, so that their calls are inlined (see chip8::BasicCpu).
+template <typename TimerType>
+void chip8::Emulator::runCpu(const std::string& programName,
+                             const std::string& version,
+                             const uint32_t clock,
+                             const chip8::OverrunPolicy overrunPolicy,
+                             const chip8::ExecutionEngine engine,
+                             const chip8::DisplayMode displayMode,
+                             chip8::RandomGenerator randomGenerator,
+                             const chip8::Palette& palette,
+                             chip8::FrameClock& frameClock,
+                             TimerType& soundTimer,
+                             TimerType& delayTimer)
+{
+    using CpuType = chip8::BasicCpu<chip8::Gpu, TimerType>;
+
     chip8::Gpu gpu(logger);
-    chip8::Timer soundTimer;
-    chip8::Timer delayTimer;
-    chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+    CpuType cpu(logger, gpu, soundTimer, delayTimer, engine, std::move(randomGenerator));
+#ifdef CHIP8_COMPILED_ROM
+    cpu.setCompiledRom(&chip8_compiled_rom); // Linked in at build time (see chip8-aot)
+#endif
+    cpu.setDisplayMode(displayMode);
 
     std::unique_ptr<std::ifstream> romData = loadRom();
     cpu.boot(*romData);
 
-    chip8::EmulatorWindow window(logger, cpu, programName, version, clock);
+    chip8::EmulatorWindow<CpuType> window(logger, cpu, frameClock, programName, version, clock, overrunPolicy, palette);
     window.run();
 }
 
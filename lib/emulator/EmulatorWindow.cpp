@@ -2,21 +2,41 @@
 
 #include <SDL_events.h>
 #include <SDL_pixels.h>
-#include <SDL_timer.h>
+#include <algorithm>
+#include <bit>
 #include <cpu/InstructionBinder.hpp>
+#include <emulator/FrameBufferExpansion.hpp>
 #include <emulator/WindowInitializationException.hpp>
 
 #include "EmulatorWindow.hpp"
 #include "SDLChip8KeyMapping.hpp"
 
-chip8::EmulatorWindow::EmulatorWindow(const logging::Logger& logger,
-                                      chip8::Cpu& cpu,
-                                      const std::string& programName,
-                                      const std::string& version,
-                                      const uint32_t clock)
+namespace
+{
+    // Called from the emulation thread: wakes up the event loop, which reads the update (see EmulatorWindow::onEmulationUpdate).
+    void onEmulationThreadUpdate()
+    {
+        SDL_Event updateEvent{};
+        updateEvent.type = SDL_USEREVENT;
+        SDL_PushEvent(&updateEvent);
+    }
+}
+
+template <typename CpuType>
+chip8::EmulatorWindow<CpuType>::EmulatorWindow(const logging::Logger& logger,
+                                               CpuType& cpu,
+                                               chip8::FrameClock& frameClock,
+                                               const std::string& programName,
+                                               const std::string& version,
+                                               const uint32_t clock,
+                                               const chip8::OverrunPolicy overrunPolicy,
+                                               const chip8::Palette& palette)
     : logger(logger)
     , cpu(cpu)
-    , clock(clock)
+    , emulation(logger, cpu, frameClock, clock, overrunPolicy, onEmulationThreadUpdate)
+    , palette(palette)
+    , textureFrame{}
+    , playingAudio(false)
     , needsDraw(false)
     , window(nullptr)
     , renderer(nullptr)
@@ -27,30 +47,21 @@ chip8::EmulatorWindow::EmulatorWindow(const logging::Logger& logger,
     logger.logInfo("Emulator window initialized.");
 }
 
-chip8::EmulatorWindow::~EmulatorWindow()
+template <typename CpuType>
+chip8::EmulatorWindow<CpuType>::~EmulatorWindow()
 {
+    emulation.stop();
+
     if (window != nullptr)
     {
         SDL_DestroyWindow(window);
     }
 }
 
-namespace
-{
-    Uint32 onInstructionTimerTick(Uint32 interval, void* data);
-}
-
-void chip8::EmulatorWindow::run()
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::run()
 {
-    // Instruction execution period in seconds T_s = 1 / f (where f is the clock frequency). T in milliseconds is T = (1 / f) * 1000 = 1000 / f
-    const uint32_t cpuPeriodMilliseconds = 1000 / clock;
-
-    // Given T, the instruction execution period in milliseconds, set the timer to tick every T milliseconds. However, if T is lower than the minimum
-    // allowed timer, set the timer to that value and run multiple instructions at once. This is because setting timers to low intervals (e.g. below 10ms)
-    // is not very accurate.
-    SDL_AddTimer(cpuPeriodMilliseconds > MinimumInstructionTimerPeriodMilliseconds ? cpuPeriodMilliseconds : MinimumInstructionTimerPeriodMilliseconds,
-                 onInstructionTimerTick,
-                 &clock);
+    emulation.start();
 
     while (processEvents())
     {
@@ -59,13 +70,15 @@ void chip8::EmulatorWindow::run()
             clearRenderer();
             drawFrame();
             presentFrame();
-            cpu.onDrawComplete();
             needsDraw = false;
         }
     }
+
+    emulation.stop();
 }
 
-void chip8::EmulatorWindow::init(const std::string& programName, const std::string& version)
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::init(const std::string& programName, const std::string& version)
 {
     const std::string windowTitle = programName + " emulator v" + version;
 
@@ -80,7 +93,8 @@ void chip8::EmulatorWindow::init(const std::string& programName, const std::stri
         throw WindowInitializationException("Cannot create window: " + std::string(SDL_GetError()));
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RendererFlags::SDL_RENDERER_ACCELERATED);
+    // Presenting waits for the display refresh: frames published in between are coalesced into the latest one (see onEmulationUpdate).
+    renderer = SDL_CreateRenderer(window, -1, SDL_RendererFlags::SDL_RENDERER_ACCELERATED | SDL_RendererFlags::SDL_RENDERER_PRESENTVSYNC);
 
     if (renderer == nullptr)
     {
@@ -112,9 +126,12 @@ void chip8::EmulatorWindow::init(const std::string& programName, const std::stri
     {
         throw WindowInitializationException("Cannot create emulator screen texture: " + std::string(SDL_GetError()));
     }
+
+    updateTexture(textureFrame, static_cast<uint32_t>((uint64_t(1) << cpu.getHeight()) - 1));
 }
 
-bool chip8::EmulatorWindow::processEvents()
+template <typename CpuType>
+bool chip8::EmulatorWindow<CpuType>::processEvents()
 {
     SDL_Event event;
     SDL_Scancode scancode;
@@ -139,7 +156,7 @@ bool chip8::EmulatorWindow::processEvents()
             scancode = event.key.keysym.scancode;
             if (chip8::SDLChip8KeyMapping.count(event.key.keysym.scancode) != 0)
             {
-                cpu.onKeyPressed(chip8::SDLChip8KeyMapping.find(scancode)->second);
+                emulation.onKeyPressed(chip8::SDLChip8KeyMapping.find(scancode)->second);
                 logger.logDebug("Key %d pressed", chip8::SDLChip8KeyMapping.find(scancode)->second);
             }
             break;
@@ -147,12 +164,12 @@ bool chip8::EmulatorWindow::processEvents()
             scancode = event.key.keysym.scancode;
             if (chip8::SDLChip8KeyMapping.count(scancode) != 0)
             {
-                cpu.onKeyReleased(chip8::SDLChip8KeyMapping.find(scancode)->second);
+                emulation.onKeyReleased(chip8::SDLChip8KeyMapping.find(scancode)->second);
                 logger.logDebug("Key %d released", chip8::SDLChip8KeyMapping.find(scancode)->second);
             }
             break;
         case SDL_EventType::SDL_USEREVENT:
-            runCpuCycle();
+            onEmulationUpdate();
             return true;
             break;
         }
@@ -161,76 +178,84 @@ bool chip8::EmulatorWindow::processEvents()
     return true;
 }
 
-void chip8::EmulatorWindow::runCpuCycle()
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::onEmulationUpdate()
 {
-    cpu.runClockCycle();
+    emulation.rethrowError();
 
-    if (cpu.shouldPlayAudio())
+    if (emulation.shouldPlayAudio() != playingAudio)
     {
-        audioController.play();
+        playingAudio = !playingAudio;
+        if (playingAudio)
+        {
+            audioController.play();
+        }
+        else
+        {
+            audioController.stop();
+        }
     }
-    else
+
+    // Frames may have been skipped since the last one: the rows to upload are found by comparing with the texture.
+    if (const auto* frame = emulation.takeFrame())
+    {
+        uint32_t dirtyRows = 0;
+        for (size_t y = 0; y < frame->size(); y++)
+        {
+            dirtyRows |= static_cast<uint32_t>((*frame)[y] != textureFrame[y]) << y;
+        }
+
+        updateTexture(*frame, dirtyRows);
+        textureFrame = *frame;
+        needsDraw = needsDraw || dirtyRows != 0;
+    }
+}
+
+// Uploads the rows from the first dirty one to the last one.
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::updateTexture(const Frame& frame, const uint32_t dirtyRows)
+{
+    if (dirtyRows == 0)
     {
-        audioController.stop();
+        return;
     }
 
-    if (cpu.getCpuState() == chip8::CpuState::WaitForDraw)
+    const int firstRow = std::countr_zero(dirtyRows);
+    const int rowCount = std::bit_width(dirtyRows) - firstRow;
+    const SDL_Rect rows{0, firstRow, static_cast<int>(cpu.getWidth()), rowCount};
+
+    // The framebuffer is expanded straight into the texture memory.
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(chip8ScreenTexture, &rows, &pixels, &pitch) != 0)
     {
-        needsDraw = true;
+        logger.logError("Cannot lock emulator screen texture: %s", SDL_GetError());
+        return;
     }
+
+    const std::span<const uint64_t> rowsToUpload = std::span<const uint64_t>(frame).subspan(firstRow, rowCount);
+    chip8::expandFrameBuffer(rowsToUpload, palette, static_cast<uint32_t*>(pixels), static_cast<size_t>(pitch));
+    SDL_UnlockTexture(chip8ScreenTexture);
 }
 
-void chip8::EmulatorWindow::clearRenderer()
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::clearRenderer()
 {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
     SDL_RenderClear(renderer);
 }
 
-void chip8::EmulatorWindow::drawFrame()
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::drawFrame()
 {
-    std::vector<uint32_t> screenPixels;
-    const auto& frameBuffer = cpu.getFrameBuffer();
-
-    screenPixels.reserve(frameBuffer.size());
-
-    for (const bool& frameBufferPixel : frameBuffer)
-    {
-        screenPixels.emplace_back(frameBufferPixel ? 0xFFFFFFF : 0xFF000000);
-    }
-
-    SDL_UpdateTexture(chip8ScreenTexture, nullptr, screenPixels.data(), cpu.getWidth() * sizeof(uint32_t));
     SDL_RenderCopy(renderer, chip8ScreenTexture, nullptr, nullptr);
 }
 
-void chip8::EmulatorWindow::presentFrame()
+template <typename CpuType>
+void chip8::EmulatorWindow<CpuType>::presentFrame()
 {
     SDL_RenderPresent(renderer);
 }
 
-namespace
-{
-    Uint32 onInstructionTimerTick(Uint32 interval, void* data)
-    {
-        SDL_Event runInstructionEvent;
-        SDL_UserEvent runInstructionUserEvent;
-
-        runInstructionUserEvent.type = SDL_USEREVENT;
-        runInstructionUserEvent.code = 0;
-        runInstructionUserEvent.data1 = nullptr;
-        runInstructionUserEvent.data2 = nullptr;
-
-        runInstructionEvent.type = SDL_USEREVENT;
-        runInstructionEvent.user = runInstructionUserEvent;
-
-        const uint32_t& clock = *reinterpret_cast<uint32_t*>(data);
-        const double instructionsPerMillisecond = static_cast<double>(clock) / 1000.0;
-        const uint32_t instructionsPerTimerTick = static_cast<uint32_t>(instructionsPerMillisecond * static_cast<double>(interval));
-
-        for (size_t i = 0; i < instructionsPerTimerTick; i++)
-        {
-            SDL_PushEvent(&runInstructionEvent);
-        }
-
-        return interval;
-    }
-}
\ No newline at end of file
+template class chip8::EmulatorWindow<chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>>;
+template class chip8::EmulatorWindow<chip8::BasicCpu<chip8::Gpu, chip8::Timer>>;
\ No newline at end of file
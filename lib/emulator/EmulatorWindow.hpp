@@ -2,24 +2,43 @@
 
 #include <SDL_render.h>
 #include <cpu/Cpu.hpp>
+#include <cpu/FrameClock.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/Timer.hpp>
+#include <emulator/Palette.hpp>
 
 #include "AudioController.hpp"
+#include "EmulationThread.hpp"
 #include "logging/Logger.hpp"
 
 namespace chip8
 {
+    // Window running a CpuType (a chip8::BasicCpu) on an emulation thread, instantiated in EmulatorWindow.cpp for the CPUs of
+    // chip8::Emulator. The window thread handles input, audio and presentation.
+    template <typename CpuType>
     class EmulatorWindow
     {
       public:
-        EmulatorWindow(const logging::Logger& logger, chip8::Cpu& cpu, const std::string& programName, const std::string& version, const uint32_t clock);
+        EmulatorWindow(const logging::Logger& logger,
+                       CpuType& cpu,
+                       chip8::FrameClock& frameClock,
+                       const std::string& programName,
+                       const std::string& version,
+                       const uint32_t clock,
+                       const chip8::OverrunPolicy overrunPolicy,
+                       const chip8::Palette& palette);
         ~EmulatorWindow();
 
         void run();
 
       private:
+        using Frame = typename chip8::EmulationThread<CpuType>::Frame;
+
         void init(const std::string& programName, const std::string& version);
         bool processEvents();
-        void runCpuCycle();
+        void onEmulationUpdate();
+        void updateTexture(const Frame& frame, const uint32_t dirtyRows);
         void clearRenderer();
         void drawFrame();
         void presentFrame();
@@ -30,17 +49,21 @@ namespace chip8
         EmulatorWindow& operator=(const EmulatorWindow&) = delete;
 
       private:
-        static constexpr uint32_t MinimumInstructionTimerPeriodMilliseconds = 10;
-
         const logging::Logger& logger;
-        chip8::Cpu& cpu;
+        CpuType& cpu;
         chip8::AudioController audioController;
+        chip8::EmulationThread<CpuType> emulation;
 
         SDL_Window* window;
         SDL_Renderer* renderer;
         SDL_Texture* chip8ScreenTexture;
 
+        const chip8::Palette palette;
+        Frame textureFrame; // Content of chip8ScreenTexture
+        bool playingAudio;
         bool needsDraw;
-        uint32_t clock;
     };
+
+    extern template class EmulatorWindow<chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>>;
+    extern template class EmulatorWindow<chip8::BasicCpu<chip8::Gpu, chip8::Timer>>;
 }
\ No newline at end of file
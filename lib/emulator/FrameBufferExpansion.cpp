@@ -0,0 +1,95 @@
+#include "emulator/FrameBufferExpansion.hpp"
+
+#include "../cpu/Simd.hpp"
+
+namespace
+{
+    constexpr size_t Width = 64;
+
+    uint32_t* getRow(uint32_t* pixels, const size_t pitch, const size_t y)
+    {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(pixels) + y * pitch);
+    }
+
+    void expandScalar(const std::span<const uint64_t> frameBuffer, const chip8::Palette& palette, uint32_t* pixels, const size_t pitch)
+    {
+        for (size_t y = 0; y < frameBuffer.size(); y++)
+        {
+            uint32_t* row = getRow(pixels, pitch, y);
+            for (size_t x = 0; x < Width; x++)
+            {
+                row[x] = (frameBuffer[y] >> (Width - 1 - x)) & 1 ? palette.foreground : palette.background;
+            }
+        }
+    }
+
+#ifdef CHIP8_SSE2_SUPPORTED
+    // 4 pixels at a time: each lane tests its own bit of the broadcast row, and the comparison selects the color.
+    void expandSse2(const std::span<const uint64_t> frameBuffer, const chip8::Palette& palette, uint32_t* pixels, const size_t pitch)
+    {
+        const __m128i bits = _mm_set_epi32(1, 2, 4, 8);
+        const __m128i foreground = _mm_set1_epi32(static_cast<int>(palette.foreground));
+        const __m128i background = _mm_set1_epi32(static_cast<int>(palette.background));
+
+        for (size_t y = 0; y < frameBuffer.size(); y++)
+        {
+            uint32_t* row = getRow(pixels, pitch, y);
+            for (size_t x = 0; x < Width; x += 4)
+            {
+                const __m128i nibble = _mm_set1_epi32(static_cast<int>(frameBuffer[y] >> (Width - 4 - x) & 0xF));
+                const __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(nibble, bits), bits);
+                const __m128i colors = _mm_or_si128(_mm_and_si128(mask, foreground), _mm_andnot_si128(mask, background));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), colors);
+            }
+        }
+    }
+#endif
+
+#ifdef CHIP8_AVX2_SUPPORTED
+    // Same as expandSse2, 8 pixels at a time.
+    CHIP8_TARGET_AVX2 void expandAvx2(const std::span<const uint64_t> frameBuffer,
+                                      const chip8::Palette& palette,
+                                      uint32_t* pixels,
+                                      const size_t pitch)
+    {
+        const __m256i bits = _mm256_set_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m256i foreground = _mm256_set1_epi32(static_cast<int>(palette.foreground));
+        const __m256i background = _mm256_set1_epi32(static_cast<int>(palette.background));
+
+        for (size_t y = 0; y < frameBuffer.size(); y++)
+        {
+            uint32_t* row = getRow(pixels, pitch, y);
+            for (size_t x = 0; x < Width; x += 8)
+            {
+                const __m256i byte = _mm256_set1_epi32(static_cast<int>(frameBuffer[y] >> (Width - 8 - x) & 0xFF));
+                const __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(byte, bits), bits);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), _mm256_blendv_epi8(background, foreground, mask));
+            }
+        }
+    }
+#endif
+}
+
+void chip8::expandFrameBuffer(const std::span<const uint64_t> frameBuffer,
+                              const chip8::Palette& palette,
+                              uint32_t* pixels,
+                              const size_t pitch,
+                              const chip8::SimdLevel level)
+{
+    switch (level)
+    {
+#ifdef CHIP8_AVX2_SUPPORTED
+    case chip8::SimdLevel::Avx2:
+        expandAvx2(frameBuffer, palette, pixels, pitch);
+        return;
+#endif
+#ifdef CHIP8_SSE2_SUPPORTED
+    case chip8::SimdLevel::Sse2:
+        expandSse2(frameBuffer, palette, pixels, pitch);
+        return;
+#endif
+    default:
+        expandScalar(frameBuffer, palette, pixels, pitch);
+        return;
+    }
+}
\ No newline at end of file
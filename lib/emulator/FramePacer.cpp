@@ -0,0 +1,71 @@
+#include "emulator/FramePacer.hpp"
+
+#include <thread>
+
+chip8::FramePacer::FramePacer(const uint32_t instructionsPerSecond, const chip8::OverrunPolicy overrunPolicy, const Clock::time_point start)
+    : instructionsPerSecond(instructionsPerSecond)
+    , overrunPolicy(overrunPolicy)
+    , start(start)
+    , instructionsCarry(0)
+    , nextFrame(start)
+    , executedInstructions(0)
+    , droppedFrames(0)
+{
+}
+
+uint32_t chip8::FramePacer::getFrameInstructions()
+{
+    const uint64_t instructions = static_cast<uint64_t>(instructionsCarry) + instructionsPerSecond;
+    instructionsCarry = static_cast<uint32_t>(instructions % FrameRate);
+    return static_cast<uint32_t>(instructions / FrameRate);
+}
+
+chip8::FramePacer::Clock::time_point chip8::FramePacer::onFrameExecuted(const uint64_t instructions, const Clock::time_point now)
+{
+    executedInstructions += instructions;
+    nextFrame += FrameDuration;
+
+    if (now <= nextFrame)
+    {
+        return nextFrame;
+    }
+
+    // Whole frames missed: the next frame starts at once, after them if they are dropped. Frames stay on the same 60 Hz grid.
+    const uint64_t missedFrames = static_cast<uint64_t>((now - nextFrame) / FrameDuration);
+    if (overrunPolicy == chip8::OverrunPolicy::Drop || missedFrames > MaxCatchUpFrames)
+    {
+        droppedFrames += missedFrames;
+        nextFrame += missedFrames * FrameDuration;
+    }
+
+    return nextFrame;
+}
+
+void chip8::FramePacer::waitUntil(const Clock::time_point deadline)
+{
+    if (Clock::now() + SpinDuration < deadline)
+    {
+        std::this_thread::sleep_until(deadline - SpinDuration);
+    }
+
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+
+uint32_t chip8::FramePacer::getRequestedRate() const
+{
+    return instructionsPerSecond;
+}
+
+double chip8::FramePacer::getAchievedRate(const Clock::time_point now) const
+{
+    const std::chrono::duration<double> elapsed = now - start;
+    return elapsed.count() > 0 ? static_cast<double>(executedInstructions) / elapsed.count() : 0;
+}
+
+uint64_t chip8::FramePacer::getDroppedFrames() const
+{
+    return droppedFrames;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "emulator/HeadlessEmulator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <emulator/FramePacer.hpp>
+
+chip8::HeadlessEmulator::HeadlessEmulator(const logging::Logger& logger, const chip8::ExecutionEngine engine, const chip8::DisplayMode displayMode)
+    : gpu(logger)
+    , soundTimer(frameClock)
+    , delayTimer(frameClock)
+    , cpu(logger, gpu, soundTimer, delayTimer, engine)
+{
+    cpu.setDisplayMode(displayMode);
+}
+
+void chip8::HeadlessEmulator::boot(std::istream& rom, chip8::RandomGenerator randomGenerator)
+{
+    gpu.clear();
+    gpu.onDrawComplete();
+    soundTimer.setValue(0);
+    delayTimer.setValue(0);
+    cpu.setRandomGenerator(std::move(randomGenerator));
+    cpu.boot(rom);
+}
+
+chip8::HeadlessEmulator::Report chip8::HeadlessEmulator::run(const chip8::InputScript& input,
+                                                             const uint32_t clock,
+                                                             const uint64_t maxFrames,
+                                                             const uint64_t maxInstructions,
+                                                             const bool realTime)
+{
+    const auto start = chip8::FramePacer::Clock::now();
+    chip8::FramePacer pacer(clock, chip8::OverrunPolicy::CatchUp, start);
+    const std::vector<chip8::InputScript::KeyEvent>& events = input.getEvents();
+    auto nextEvent = events.begin();
+
+    Report report{};
+    while ((maxFrames == 0 || report.frames < maxFrames) && (maxInstructions == 0 || report.instructions < maxInstructions))
+    {
+        for (; nextEvent != events.end() && nextEvent->frame <= report.frames; ++nextEvent)
+        {
+            if (nextEvent->pressed)
+            {
+                cpu.onKeyPressed(nextEvent->key);
+            }
+            else
+            {
+                cpu.onKeyReleased(nextEvent->key);
+            }
+        }
+
+        uint64_t frameInstructions = pacer.getFrameInstructions();
+        if (maxInstructions != 0)
+        {
+            frameInstructions = std::min(frameInstructions, maxInstructions - report.instructions);
+        }
+
+        const chip8::RunResult result = cpu.run(frameInstructions);
+        frameClock.tick();
+        report.instructions += result.instructions;
+        report.frames++;
+
+        if (result.frameDirty)
+        {
+            report.drawnFrames += cpu.getDirtyRows() != 0 ? 1 : 0;
+            cpu.onDrawComplete();
+        }
+
+        // Without a frame limit, a program waiting for a key nobody will press would never reach the instruction limit.
+        if (result.stopReason == chip8::StopReason::WaitForKey && nextEvent == events.end() && maxFrames == 0)
+        {
+            report.waitingForKey = true;
+            break;
+        }
+
+        const chip8::FramePacer::Clock::time_point nextFrame = pacer.onFrameExecuted(result.instructions);
+        if (realTime)
+        {
+            chip8::FramePacer::waitUntil(nextFrame);
+        }
+    }
+
+    report.frameBufferHash = hashFrameBuffer(cpu.getFrameBuffer());
+    report.seconds = std::chrono::duration<double>(chip8::FramePacer::Clock::now() - start).count();
+    return report;
+}
+
+uint64_t chip8::HeadlessEmulator::hashFrameBuffer(std::span<const uint64_t> frameBuffer)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const uint64_t row : frameBuffer)
+    {
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            hash = (hash ^ (row >> shift & 0xFF)) * 0x100000001b3;
+        }
+    }
+
+    return hash;
+}
\ No newline at end of file
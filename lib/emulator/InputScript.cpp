@@ -0,0 +1,45 @@
+#include "emulator/InputScript.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <emulator/InputScriptException.hpp>
+#include <sstream>
+#include <string>
+
+chip8::InputScript::InputScript(std::istream& script)
+{
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(script, line); lineNumber++)
+    {
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream frameField(first);
+        uint64_t frame = 0;
+        unsigned key = 0;
+        std::string action;
+        std::string extra;
+
+        // The frame must start with a digit: unsigned extraction would accept a minus sign.
+        const bool valid = std::isdigit(static_cast<unsigned char>(first[0])) && frameField >> frame && frameField.eof() &&
+                           fields >> std::hex >> key && key <= 0xF && fields >> action && (action == "down" || action == "up") &&
+                           !(fields >> extra);
+        if (!valid)
+        {
+            throw chip8::InputScriptException("line " + std::to_string(lineNumber) + ": expected <frame> <key> down|up, got \"" + line + "\"");
+        }
+
+        events.push_back({frame, static_cast<chip8::Key>(key), action == "down"});
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const KeyEvent& event1, const KeyEvent& event2) { return event1.frame < event2.frame; });
+}
+
+const std::vector<chip8::InputScript::KeyEvent>& chip8::InputScript::getEvents() const
+{
+    return events;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "env/VecEnv.hpp"
+
+#include <algorithm>
+#include <cpu/Key.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+chip8::env::VecEnv::VecEnv(const logging::Logger& logger,
+                           std::istream& rom,
+                           const size_t instances,
+                           const uint64_t seed,
+                           chip8::env::VecEnvOptions options,
+                           const chip8::SimdLevel level)
+    : instances(instances)
+    , options(std::move(options))
+    , cpu(logger, instances, level)
+    , startState{}
+    , nextSeed(seed + instances)
+    , currentValues(instances * this->options.watched.size())
+    , previousValues(instances * this->options.watched.size())
+    , rewards(instances)
+    , done(instances)
+{
+    for (const chip8::env::Location& location : this->options.watched)
+    {
+        const size_t size = location.kind == chip8::env::Location::Kind::Register ? 16 : chip8::LockstepCpu::MemorySize;
+        if (location.index >= size)
+        {
+            throw std::invalid_argument("Watched location out of bounds: " + std::to_string(location.index));
+        }
+    }
+
+    std::vector<uint64_t> seeds(instances);
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        seeds[instance] = seed + instance;
+    }
+
+    // The start frames run once, on a single lane whose state then starts every instance.
+    chip8::LockstepCpu startCpu(logger, 1, level);
+    startCpu.boot(rom, std::span<const uint64_t>(&seed, 1));
+    for (size_t frame = 0; frame < this->options.startFrames; frame++)
+    {
+        startCpu.run(this->options.instructionsPerFrame);
+        startCpu.tickTimers();
+    }
+
+    startState = startCpu.save(0);
+    cpu.boot(rom, seeds);
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        cpu.restore(instance, startState, seeds[instance]);
+        readWatched(instance, getValues(currentValues, instance));
+    }
+}
+
+chip8::env::StepResult chip8::env::VecEnv::reset()
+{
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        resetInstance(instance);
+    }
+
+    return getResult();
+}
+
+chip8::env::StepResult chip8::env::VecEnv::step(const std::span<const uint16_t> actions)
+{
+    if (actions.size() != instances)
+    {
+        throw std::invalid_argument("Every instance needs an action");
+    }
+
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        if (done[instance] != 0)
+        {
+            resetInstance(instance);
+        }
+
+        for (size_t key = 0; key < 16; key++)
+        {
+            if ((actions[instance] >> key & 1) != 0)
+            {
+                cpu.onKeyPressed(instance, static_cast<chip8::Key>(key));
+            }
+            else
+            {
+                cpu.onKeyReleased(instance, static_cast<chip8::Key>(key));
+            }
+        }
+    }
+
+    for (size_t frame = 0; frame < options.framesPerStep; frame++)
+    {
+        cpu.run(options.instructionsPerFrame);
+        cpu.tickTimers();
+    }
+
+    std::swap(currentValues, previousValues);
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        const std::span<uint8_t> current = getValues(currentValues, instance);
+        readWatched(instance, current);
+
+        rewards[instance] = options.reward ? options.reward(current, getValues(previousValues, instance)) : 0.0f;
+        done[instance] = cpu.getError(instance).has_value() || (options.done && options.done(current));
+    }
+
+    return getResult();
+}
+
+size_t chip8::env::VecEnv::getInstanceCount() const
+{
+    return instances;
+}
+
+const chip8::LockstepCpu& chip8::env::VecEnv::getCpu() const
+{
+    return cpu;
+}
+
+void chip8::env::VecEnv::resetInstance(const size_t instance)
+{
+    cpu.restore(instance, startState, nextSeed++);
+    readWatched(instance, getValues(currentValues, instance));
+    rewards[instance] = 0.0f;
+    done[instance] = 0;
+}
+
+void chip8::env::VecEnv::readWatched(const size_t instance, const std::span<uint8_t> values) const
+{
+    for (size_t i = 0; i < options.watched.size(); i++)
+    {
+        const chip8::env::Location& location = options.watched[i];
+        values[i] = location.kind == chip8::env::Location::Kind::Register ? cpu.getV(instance, location.index)
+                                                                           : cpu.readMemory(instance, location.index);
+    }
+}
+
+std::span<uint8_t> chip8::env::VecEnv::getValues(std::vector<uint8_t>& values, const size_t instance) const
+{
+    return std::span<uint8_t>(values).subspan(instance * options.watched.size(), options.watched.size());
+}
+
+chip8::env::StepResult chip8::env::VecEnv::getResult() const
+{
+    return {cpu.getFrameBuffers(), rewards, done};
+}
\ No newline at end of file
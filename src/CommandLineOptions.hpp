@@ -1,10 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <cpu/DisplayMode.hpp>
+#include <cpu/ExecutionEngine.hpp>
+#include <cpu/RandomGenerator.hpp>
+#include <emulator/OverrunPolicy.hpp>
+#include <emulator/Palette.hpp>
+#include <emulator/TimerMode.hpp>
+#include <sstream>
+#include <string>
+
 #include "clparser/Argument.hpp"
+#include "clparser/ArgumentFormatException.hpp"
 #include "clparser/CommandLineOptions.hpp"
 #include "clparser/NamedArgument.hpp"
 #include "clparser/PositionalArgument.hpp"
 
+#include "ExecutionEngineOption.hpp"
+
 namespace chip8
 {
     class CommandLineOptions : public clparser::CommandLineOptions
@@ -14,6 +28,19 @@ namespace chip8
             : clparser::CommandLineOptions(help, version)
             , romName(*this, "rom", clparser::required<std::string>())
             , clock(*this, "c", "clock", "Number of instructions per second", clparser::optional<uint32_t>(1000))
+            , overrun(*this, "o", "overrun", "What to do with frames that run late: catchup, drop", clparser::optional<std::string>("catchup"))
+            , engine(*this, "e", "engine", chip8::ExecutionEngineHelp, clparser::optional<std::string>("interpreter"))
+            , timers(*this, "t", "timers", "Timer mode: frame, wallclock", clparser::optional<std::string>("frame"))
+            , display(*this, "d", "display", "Display mode: coalesced, wait (DRW waits for the next frame)", clparser::optional<std::string>("coalesced"))
+            , random(*this, "r", "random", "Random number generator: xorshift, standard", clparser::optional<std::string>("xorshift"))
+            , seed(*this, "s", "seed", "Seed of the random number generator, or random", clparser::optional<std::string>("random"))
+            , foreground(*this, "fg", "foreground", "Color of the pixels that are on, as RRGGBB", clparser::optional<std::string>("FFFFFF"))
+            , background(*this, "bg", "background", "Color of the pixels that are off, as RRGGBB", clparser::optional<std::string>("000000"))
+            , headless(*this, "hl", "headless", "Runs without window, audio nor input events and prints a report (see --frames)")
+            , frames(*this, "f", "frames", "Headless: number of frames to run, 0 for no limit", clparser::optional<uint32_t>(600))
+            , instructions(*this, "n", "instructions", "Headless: number of instructions to run, 0 for no limit", clparser::optional<uint32_t>(0))
+            , input(*this, "i", "input", "Headless: input script, with lines such as \"120 5 down\" (frame, key, down|up)", clparser::optional<std::string>(""))
+            , realTime(*this, "rt", "realtime", "Headless: runs frames at 60 Hz instead of as fast as possible")
             , verbose(*this, "ver", "verbose", "Displays all log message")
             , help(*this, "h", "help", "Displays this help")
             , version(*this, "v", "version", "Shows this program version")
@@ -22,8 +49,122 @@ namespace chip8
 
         clparser::PositionalArgument<std::string> romName;
         clparser::NamedArgument<uint32_t> clock;
+        clparser::NamedArgument<std::string> overrun;
+        clparser::NamedArgument<std::string> engine;
+        clparser::NamedArgument<std::string> timers;
+        clparser::NamedArgument<std::string> display;
+        clparser::NamedArgument<std::string> random;
+        clparser::NamedArgument<std::string> seed;
+        clparser::NamedArgument<std::string> foreground;
+        clparser::NamedArgument<std::string> background;
+        clparser::NamedArgument<bool> headless;
+        clparser::NamedArgument<uint32_t> frames;
+        clparser::NamedArgument<uint32_t> instructions;
+        clparser::NamedArgument<std::string> input;
+        clparser::NamedArgument<bool> realTime;
         clparser::NamedArgument<bool> verbose;
         clparser::NamedArgument<bool> help;
         clparser::NamedArgument<bool> version;
+
+        chip8::OverrunPolicy getOverrunPolicy() const
+        {
+            if (overrun() == "catchup")
+            {
+                return chip8::OverrunPolicy::CatchUp;
+            }
+
+            if (overrun() == "drop")
+            {
+                return chip8::OverrunPolicy::Drop;
+            }
+
+            throw clparser::ArgumentFormatException("--overrun", overrun());
+        }
+
+        chip8::ExecutionEngine getExecutionEngine() const
+        {
+            return chip8::parseExecutionEngine(engine());
+        }
+
+        chip8::TimerMode getTimerMode() const
+        {
+            if (timers() == "frame")
+            {
+                return chip8::TimerMode::Frame;
+            }
+
+            if (timers() == "wallclock")
+            {
+                return chip8::TimerMode::WallClock;
+            }
+
+            throw clparser::ArgumentFormatException("--timers", timers());
+        }
+
+        chip8::DisplayMode getDisplayMode() const
+        {
+            if (display() == "coalesced")
+            {
+                return chip8::DisplayMode::Coalesced;
+            }
+
+            if (display() == "wait")
+            {
+                return chip8::DisplayMode::DisplayWait;
+            }
+
+            throw clparser::ArgumentFormatException("--display", display());
+        }
+
+        chip8::RandomEngine getRandomEngine() const
+        {
+            if (random() == "xorshift")
+            {
+                return chip8::RandomEngine::Xorshift;
+            }
+
+            if (random() == "standard")
+            {
+                return chip8::RandomEngine::Standard;
+            }
+
+            throw clparser::ArgumentFormatException("--random", random());
+        }
+
+        uint64_t getSeed() const
+        {
+            if (seed() == "random")
+            {
+                return chip8::RandomGenerator::createRandomSeed();
+            }
+
+            // Must start with a digit: unsigned extraction would accept a minus sign.
+            std::istringstream stream(seed());
+            uint64_t value = 0;
+            if (seed().empty() || !std::isdigit(static_cast<unsigned char>(seed()[0])) || !(stream >> value) || !stream.eof())
+            {
+                throw clparser::ArgumentFormatException("--seed", seed());
+            }
+
+            return value;
+        }
+
+        chip8::Palette getPalette() const
+        {
+            return {parseColor("--foreground", foreground()), parseColor("--background", background())};
+        }
+
+      private:
+        // RRGGBB to opaque ARGB8888.
+        static uint32_t parseColor(const std::string& name, const std::string& color)
+        {
+            const auto isHexDigit = [](const char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
+            if (color.size() != 6 || !std::all_of(color.begin(), color.end(), isHexDigit))
+            {
+                throw clparser::ArgumentFormatException(name, color);
+            }
+
+            return 0xFF000000 | static_cast<uint32_t>(std::stoul(color, nullptr, 16));
+        }
     };
 }
\ No newline at end of file
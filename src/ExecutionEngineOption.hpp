@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cpu/ExecutionEngine.hpp>
+#include <string>
+
+#include "clparser/ArgumentFormatException.hpp"
+
+namespace chip8
+{
+    // --engine option of the frontends running ROMs.
+    static constexpr char ExecutionEngineHelp[] = "Execution engine: interpreter, cached, block, threaded, jit";
+
+    inline chip8::ExecutionEngine parseExecutionEngine(const std::string& name)
+    {
+        if (name == "interpreter")
+        {
+            return chip8::ExecutionEngine::Interpreter;
+        }
+
+        if (name == "cached")
+        {
+            return chip8::ExecutionEngine::CachedInterpreter;
+        }
+
+        if (name == "block")
+        {
+            return chip8::ExecutionEngine::BasicBlock;
+        }
+
+        if (name == "threaded")
+        {
+            return chip8::ExecutionEngine::Threaded;
+        }
+
+        if (name == "jit")
+        {
+            return chip8::ExecutionEngine::Jit;
+        }
+
+        throw clparser::ArgumentFormatException("--engine", name);
+    }
+}
\ No newline at end of file
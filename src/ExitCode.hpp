@@ -9,6 +9,10 @@ namespace chip8
         WindowInitializationFailure = 2,
         AudioInitializationFailure = 3,
         RomLoadFailure = 4,
-        CpuError = 5
+        CpuError = 5,
+        OutputWriteFailure = 6,
+        InputScriptFailure = 7,
+        ManifestReadFailure = 8,
+        UnexpectedFailure = 9
     };
 }
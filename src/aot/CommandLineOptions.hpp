@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "clparser/Argument.hpp"
+#include "clparser/CommandLineOptions.hpp"
+#include "clparser/NamedArgument.hpp"
+#include "clparser/PositionalArgument.hpp"
+
+namespace chip8::aot
+{
+    class CommandLineOptions : public clparser::CommandLineOptions
+    {
+      public:
+        CommandLineOptions()
+            : clparser::CommandLineOptions(help, version)
+            , romName(*this, "rom", clparser::required<std::string>())
+            , outputName(*this, "output", clparser::required<std::string>())
+            , verbose(*this, "ver", "verbose", "Displays all log message")
+            , help(*this, "h", "help", "Displays this help")
+            , version(*this, "v", "version", "Shows this program version")
+        {
+        }
+
+        clparser::PositionalArgument<std::string> romName;
+        clparser::PositionalArgument<std::string> outputName;
+        clparser::NamedArgument<bool> verbose;
+        clparser::NamedArgument<bool> help;
+        clparser::NamedArgument<bool> version;
+    };
+}
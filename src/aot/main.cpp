@@ -0,0 +1,82 @@
+#include <aot/RomTranslator.hpp>
+#include <clparser/ArgumentFormatException.hpp>
+#include <clparser/ArgumentNotFoundException.hpp>
+#include <clparser/CommandLineParser.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "../ExitCode.hpp"
+#include "../Logger.hpp"
+#include "../metadata.hpp"
+#include "CommandLineOptions.hpp"
+
+namespace
+{
+    constexpr char ProgramName[] = "chip8-aot";
+}
+
+// Translates a ROM into a C++ translation unit to be compiled with the emulator (see chip8::Cpu::setCompiledRom).
+int main(int argc, char* argv[])
+{
+    chip8::aot::CommandLineOptions options;
+    clparser::CommandLineParser parser(argc, argv);
+    chip8::Logger logger;
+
+    try
+    {
+        parser.parse(options);
+        if (options.version())
+        {
+            std::cout << ProgramName << " version " << chip8::metadata::Version << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        if (options.help())
+        {
+            std::cout << options.getHelpMessage(ProgramName) << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        logger.setVerbose(options.verbose());
+
+        std::ifstream romFile(options.romName(), std::ios::binary);
+        if (romFile.fail())
+        {
+            throw chip8::RomLoadFailureException("Couldn't open ROM " + options.romName());
+        }
+
+        const std::vector<uint8_t> rom{std::istreambuf_iterator<char>(romFile), std::istreambuf_iterator<char>()};
+        const chip8::aot::RomTranslator translator(rom);
+
+        std::ofstream outputFile(options.outputName());
+        outputFile << translator.translate(std::filesystem::path(options.romName()).filename().string());
+        if (outputFile.fail())
+        {
+            logger.logError("Couldn't write %s", options.outputName());
+            return chip8::ExitCode::OutputWriteFailure;
+        }
+
+        logger.logInfo("Translated %d blocks", static_cast<int>(translator.getBlocks().size()));
+    }
+    catch (clparser::ArgumentNotFoundException& argNotFound)
+    {
+        logger.logError(argNotFound.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (clparser::ArgumentFormatException& argWrongFormat)
+    {
+        logger.logError(argWrongFormat.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (chip8::RomLoadFailureException& romLoadFailure)
+    {
+        logger.logError(romLoadFailure.what());
+        return chip8::ExitCode::RomLoadFailure;
+    }
+
+    return chip8::ExitCode::Success;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cpu/ExecutionEngine.hpp>
+#include <string>
+
+#include "clparser/Argument.hpp"
+#include "clparser/ArgumentFormatException.hpp"
+#include "clparser/CommandLineOptions.hpp"
+#include "clparser/NamedArgument.hpp"
+#include "clparser/PositionalArgument.hpp"
+
+#include "../ExecutionEngineOption.hpp"
+
+namespace chip8::batch
+{
+    class CommandLineOptions : public clparser::CommandLineOptions
+    {
+      public:
+        CommandLineOptions()
+            : clparser::CommandLineOptions(help, version)
+            , manifestName(*this, "manifest", clparser::required<std::string>())
+            , outputName(*this, "output", clparser::required<std::string>())
+            , threads(*this, "j", "threads", "Number of threads, 0 for one per hardware thread", clparser::optional<uint32_t>(0))
+            , clock(*this, "c", "clock", "Number of instructions per second of the virtual 60 Hz frames", clparser::optional<uint32_t>(1000))
+            , engine(*this, "e", "engine", chip8::ExecutionEngineHelp, clparser::optional<std::string>("jit"))
+            , verbose(*this, "ver", "verbose", "Displays all log message")
+            , help(*this, "h", "help", "Displays this help")
+            , version(*this, "v", "version", "Shows this program version")
+        {
+        }
+
+        clparser::PositionalArgument<std::string> manifestName;
+        clparser::PositionalArgument<std::string> outputName;
+        clparser::NamedArgument<uint32_t> threads;
+        clparser::NamedArgument<uint32_t> clock;
+        clparser::NamedArgument<std::string> engine;
+        clparser::NamedArgument<bool> verbose;
+        clparser::NamedArgument<bool> help;
+        clparser::NamedArgument<bool> version;
+
+        // Jobs have no frame limit: without instructions per frame, HeadlessEmulator::run would never end.
+        uint32_t getClock() const
+        {
+            if (clock() == 0)
+            {
+                throw clparser::ArgumentFormatException("--clock", std::to_string(clock()));
+            }
+
+            return clock();
+        }
+
+        chip8::ExecutionEngine getExecutionEngine() const
+        {
+            return chip8::parseExecutionEngine(engine());
+        }
+    };
+}
\ No newline at end of file
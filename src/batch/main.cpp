@@ -0,0 +1,221 @@
+#include <batch/BatchManifest.hpp>
+#include <batch/ManifestException.hpp>
+#include <batch/WorkStealingPool.hpp>
+#include <chrono>
+#include <clparser/ArgumentFormatException.hpp>
+#include <clparser/ArgumentNotFoundException.hpp>
+#include <clparser/CommandLineParser.hpp>
+#include <cpu/CpuExecutionException.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <emulator/HeadlessEmulator.hpp>
+#include <emulator/InputScript.hpp>
+#include <emulator/InputScriptException.hpp>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#include "../ExitCode.hpp"
+#include "../Logger.hpp"
+#include "../metadata.hpp"
+#include "CommandLineOptions.hpp"
+
+namespace
+{
+    constexpr char ProgramName[] = "chip8-batch";
+
+    struct JobResult
+    {
+        chip8::HeadlessEmulator::Report report;
+        std::string error; // Empty if the job succeeded
+    };
+
+    // ROMs and input scripts are read once, before the jobs start, however many jobs share them.
+    std::map<std::filesystem::path, std::string> loadRoms(const std::vector<chip8::batch::BatchJob>& jobs)
+    {
+        std::map<std::filesystem::path, std::string> roms;
+        for (const chip8::batch::BatchJob& job : jobs)
+        {
+            if (roms.contains(job.rom))
+            {
+                continue;
+            }
+
+            std::ifstream romFile(job.rom, std::ios::binary);
+            if (romFile.fail())
+            {
+                throw chip8::RomLoadFailureException("Couldn't open ROM " + job.rom.string());
+            }
+
+            std::ostringstream rom;
+            rom << romFile.rdbuf();
+            roms[job.rom] = rom.str();
+        }
+
+        return roms;
+    }
+
+    std::map<std::filesystem::path, chip8::InputScript> loadInputScripts(const std::vector<chip8::batch::BatchJob>& jobs)
+    {
+        std::map<std::filesystem::path, chip8::InputScript> inputScripts{{{}, chip8::InputScript()}};
+        for (const chip8::batch::BatchJob& job : jobs)
+        {
+            if (inputScripts.contains(job.inputScript))
+            {
+                continue;
+            }
+
+            std::ifstream script(job.inputScript);
+            if (script.fail())
+            {
+                throw chip8::InputScriptException("couldn't open " + job.inputScript.string());
+            }
+
+            inputScripts[job.inputScript] = chip8::InputScript(script);
+        }
+
+        return inputScripts;
+    }
+
+    // One line per job, in the order of the manifest: job, frame buffer hash, frames, instructions, instructions per second, status.
+    void writeResults(std::ostream& output, const std::vector<JobResult>& results)
+    {
+        output << "# job\thash\tframes\tinstructions\tips\tstatus\n";
+        for (size_t job = 0; job < results.size(); job++)
+        {
+            const chip8::HeadlessEmulator::Report& report = results[job].report;
+            const std::string status = !results[job].error.empty() ? "error: " + results[job].error : report.waitingForKey ? "waiting" : "ok";
+
+            output << job << '\t' << std::hex << std::setw(16) << std::setfill('0') << report.frameBufferHash << std::dec << '\t' << report.frames
+                   << '\t' << report.instructions << '\t' << std::fixed << std::setprecision(0)
+                   << (report.seconds > 0 ? static_cast<double>(report.instructions) / report.seconds : 0.0) << '\t' << status << '\n';
+        }
+    }
+}
+
+// Runs the jobs of a manifest headlessly on all the cores (see chip8::HeadlessEmulator), and writes what each of them did.
+int main(int argc, char* argv[])
+{
+    chip8::batch::CommandLineOptions options;
+    clparser::CommandLineParser parser(argc, argv);
+    chip8::Logger logger;
+    int exitCode = chip8::ExitCode::Success;
+
+    try
+    {
+        parser.parse(options);
+        if (options.version())
+        {
+            std::cout << ProgramName << " version " << chip8::metadata::Version << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        if (options.help())
+        {
+            std::cout << options.getHelpMessage(ProgramName) << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        logger.setVerbose(options.verbose());
+
+        std::ifstream manifest(options.manifestName());
+        if (manifest.fail())
+        {
+            throw chip8::batch::ManifestException("couldn't open " + options.manifestName());
+        }
+
+        const std::vector<chip8::batch::BatchJob> jobs =
+            chip8::batch::readManifest(manifest, std::filesystem::path(options.manifestName()).parent_path());
+        const std::map<std::filesystem::path, std::string> roms = loadRoms(jobs);
+        const std::map<std::filesystem::path, chip8::InputScript> inputScripts = loadInputScripts(jobs);
+        const chip8::ExecutionEngine engine = options.getExecutionEngine();
+        const uint32_t clock = options.getClock();
+
+        chip8::batch::WorkStealingPool pool(options.threads());
+        // One emulator per worker, reused from one job to the next and created by the thread using it.
+        std::vector<std::unique_ptr<chip8::HeadlessEmulator>> emulators(pool.getThreadCount());
+        std::vector<JobResult> results(jobs.size());
+
+        const auto start = std::chrono::steady_clock::now();
+        pool.run(jobs.size(), [&](const size_t job, const size_t worker) {
+            if (!emulators[worker])
+            {
+                emulators[worker] = std::make_unique<chip8::HeadlessEmulator>(logger, engine, chip8::DisplayMode::Coalesced);
+            }
+
+            try
+            {
+                std::istringstream rom(roms.at(jobs[job].rom));
+                emulators[worker]->boot(rom, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, jobs[job].seed));
+                results[job].report = emulators[worker]->run(inputScripts.at(jobs[job].inputScript), clock, 0, jobs[job].instructions, false);
+            }
+            catch (chip8::CpuExecutionException& cpuError)
+            {
+                results[job].error = cpuError.what();
+            }
+            catch (chip8::RomLoadFailureException& romLoadFailure)
+            {
+                results[job].error = romLoadFailure.what();
+            }
+        });
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        std::ofstream output(options.outputName());
+        writeResults(output, results);
+        if (output.fail())
+        {
+            logger.logError("Couldn't write %s", options.outputName());
+            return chip8::ExitCode::OutputWriteFailure;
+        }
+
+        uint64_t instructions = 0;
+        for (const JobResult& result : results)
+        {
+            instructions += result.report.instructions;
+            if (!result.error.empty())
+            {
+                exitCode = chip8::ExitCode::CpuError;
+            }
+        }
+
+        std::cout << jobs.size() << " jobs on " << pool.getThreadCount() << " threads in " << std::fixed << std::setprecision(3) << duration.count()
+                  << " s: " << std::setprecision(1) << static_cast<double>(instructions) / duration.count() / 1e6 << " M instructions/s" << std::endl;
+    }
+    catch (clparser::ArgumentNotFoundException& argNotFound)
+    {
+        logger.logError(argNotFound.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (clparser::ArgumentFormatException& argWrongFormat)
+    {
+        logger.logError(argWrongFormat.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (chip8::batch::ManifestException& manifestFailure)
+    {
+        logger.logError(manifestFailure.what());
+        return chip8::ExitCode::ManifestReadFailure;
+    }
+    catch (chip8::InputScriptException& inputScriptFailure)
+    {
+        logger.logError(inputScriptFailure.what());
+        return chip8::ExitCode::InputScriptFailure;
+    }
+    catch (chip8::RomLoadFailureException& romLoadFailure)
+    {
+        logger.logError(romLoadFailure.what());
+        return chip8::ExitCode::RomLoadFailure;
+    }
+    // Anything else a job can throw, e.g. std::bad_alloc, which the pool rethrows once every job ran.
+    catch (std::exception& unexpectedFailure)
+    {
+        logger.logError(unexpectedFailure.what());
+        return chip8::ExitCode::UnexpectedFailure;
+    }
+
+    return exitCode;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+#include "clparser/Argument.hpp"
+#include "clparser/CommandLineOptions.hpp"
+#include "clparser/NamedArgument.hpp"
+#include "clparser/PositionalArgument.hpp"
+
+namespace chip8::benchmark
+{
+    class CommandLineOptions : public clparser::CommandLineOptions
+    {
+      public:
+        CommandLineOptions()
+            : clparser::CommandLineOptions(help, version)
+            , romName(*this, "rom", clparser::required<std::string>())
+            , instructions(*this, "n", "instructions", "Number of instructions executed per engine", clparser::optional<uint32_t>(100000000))
+            , profile(*this, "p", "profile", "Counts the pairs of consecutive instructions executed instead of measuring the engines")
+            , verbose(*this, "ver", "verbose", "Displays all log message")
+            , help(*this, "h", "help", "Displays this help")
+            , version(*this, "v", "version", "Shows this program version")
+        {
+        }
+
+        clparser::PositionalArgument<std::string> romName;
+        clparser::NamedArgument<uint32_t> instructions;
+        clparser::NamedArgument<bool> profile;
+        clparser::NamedArgument<bool> verbose;
+        clparser::NamedArgument<bool> help;
+        clparser::NamedArgument<bool> version;
+    };
+}
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <chrono>
+#include <clparser/ArgumentFormatException.hpp>
+#include <clparser/ArgumentNotFoundException.hpp>
+#include <clparser/CommandLineParser.hpp>
+#include <cpu/Cpu.hpp>
+#include <cpu/CpuExecutionException.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "../ExitCode.hpp"
+#include "../Logger.hpp"
+#include "../metadata.hpp"
+#include "CommandLineOptions.hpp"
+
+namespace
+{
+    constexpr char ProgramName[] = "chip8-benchmark";
+
+    // Instructions executed per simulated frame, during which a key is pressed. Timers tick once per frame (see chip8::FrameTimer) and
+    // random numbers come from the default seed, so that all the engines execute the same instructions.
+    constexpr size_t InstructionsPerFrame = 10000;
+
+    constexpr size_t ProgramStartLocation = 0x200;
+    constexpr size_t ProfiledPairs = 24;
+
+    struct Engine
+    {
+        const char* name;
+        chip8::ExecutionEngine engine;
+    };
+
+    constexpr Engine Engines[] = {{"interpreter", chip8::ExecutionEngine::Interpreter},
+                                  {"cached", chip8::ExecutionEngine::CachedInterpreter},
+                                  {"block", chip8::ExecutionEngine::BasicBlock},
+                                  {"threaded", chip8::ExecutionEngine::Threaded},
+                                  {"jit", chip8::ExecutionEngine::Jit}};
+
+    using InstructionPair = std::pair<uint8_t, uint8_t>;
+
+    // As in the emulator, peripherals are called directly rather than through their interfaces.
+    using BenchmarkCpu = chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer>;
+
+    // The ROMs to run: the given file, or all the files of the given directory.
+    std::vector<std::filesystem::path> findRoms(const std::string& romName)
+    {
+        if (!std::filesystem::is_directory(romName))
+        {
+            return {romName};
+        }
+
+        std::vector<std::filesystem::path> roms;
+        for (const auto& entry : std::filesystem::directory_iterator(romName))
+        {
+            if (entry.is_regular_file())
+            {
+                roms.push_back(entry.path());
+            }
+        }
+
+        std::sort(roms.begin(), roms.end());
+        return roms;
+    }
+
+    std::string loadRom(const std::filesystem::path& romName)
+    {
+        std::ifstream romFile(romName, std::ios::binary);
+        if (romFile.fail())
+        {
+            throw chip8::RomLoadFailureException("Couldn't open ROM " + romName.string());
+        }
+
+        std::ostringstream rom;
+        rom << romFile.rdbuf();
+        return rom.str();
+    }
+
+    // Runs the ROM headlessly, pressing the keys one after the other so that programs waiting for input make progress. A frame ends early
+    // if the program waits for a key. onRun is called after every call to Cpu::run with the number of instructions it executed.
+    template <typename OnRun>
+    void runRom(const chip8::Logger& logger,
+                const std::string& rom,
+                const chip8::ExecutionEngine engine,
+                const size_t instructions,
+                const size_t instructionsPerRun,
+                OnRun onRun)
+    {
+        chip8::Gpu gpu(logger);
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer(frameClock);
+        chip8::FrameTimer delayTimer(frameClock);
+        BenchmarkCpu cpu(logger, gpu, soundTimer, delayTimer, engine);
+
+        std::istringstream romData(rom);
+        cpu.boot(romData);
+
+        size_t executedInstructions = 0;
+        for (size_t frame = 0; executedInstructions < instructions; frame++)
+        {
+            const auto key = static_cast<chip8::Key>(frame % 16);
+            const size_t frameEnd = std::min(executedInstructions + InstructionsPerFrame, instructions);
+            cpu.onKeyPressed(key);
+
+            while (executedInstructions < frameEnd)
+            {
+                const chip8::RunResult result = cpu.run(std::min(instructionsPerRun, frameEnd - executedInstructions));
+                executedInstructions += result.instructions;
+                onRun(cpu, result.instructions);
+
+                if (result.stopReason == chip8::StopReason::WaitForKey)
+                {
+                    break;
+                }
+            }
+
+            cpu.onKeyReleased(key);
+            frameClock.tick();
+        }
+    }
+
+    // Returns the number of instructions executed per second.
+    double measure(const chip8::Logger& logger, const std::string& rom, const chip8::ExecutionEngine engine, const size_t instructions)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        runRom(logger, rom, engine, instructions, InstructionsPerFrame, [](BenchmarkCpu&, size_t) {});
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        return static_cast<double>(instructions) / duration.count();
+    }
+
+    // Counts the pairs of instructions executed one after the other from consecutive addresses of the ROM, i.e. the candidates for
+    // superinstructions (see Cpu::runThreaded). Returns the total number of instructions executed.
+    size_t profile(const chip8::Logger& logger, const std::string& rom, const size_t instructions, std::map<InstructionPair, size_t>& pairs)
+    {
+        const chip8::BasicInstructionSet<BenchmarkCpu>& instructionSet = chip8::BasicInstructionSet<BenchmarkCpu>::getInstance();
+        size_t previousAddress = 0;
+        uint8_t previousIndex = 0;
+        size_t executedInstructions = 0;
+
+        runRom(logger, rom, chip8::ExecutionEngine::Interpreter, instructions, 1, [&](BenchmarkCpu& cpu, size_t) {
+            executedInstructions++;
+
+            // Instructions are read from the ROM image: code copied elsewhere or modified at run time is not profiled.
+            const size_t address = *cpu.getRegisters().PC;
+            if (address < ProgramStartLocation || address + 1 >= ProgramStartLocation + rom.size())
+            {
+                previousAddress = 0;
+                return;
+            }
+
+            const uint8_t byte1 = static_cast<uint8_t>(rom[address - ProgramStartLocation]);
+            const uint8_t byte2 = static_cast<uint8_t>(rom[address - ProgramStartLocation + 1]);
+            const uint8_t index = instructionSet.decode(byte1, byte2).index;
+
+            if (address == previousAddress + 2)
+            {
+                pairs[{previousIndex, index}]++;
+            }
+
+            previousAddress = address;
+            previousIndex = index;
+        });
+
+        return executedInstructions;
+    }
+
+    // e.g. 8..4 for ADD Vx, Vy.
+    std::string describe(const uint8_t index)
+    {
+        const auto pattern = chip8::BasicInstructionSet<BenchmarkCpu>::getPattern(index);
+        std::ostringstream description;
+
+        for (int shift = 12; shift >= 0; shift -= 4)
+        {
+            if ((pattern.mask >> shift & 0xF) == 0)
+            {
+                description << '.';
+            }
+            else
+            {
+                description << std::uppercase << std::hex << (pattern.value >> shift & 0xF);
+            }
+        }
+
+        return description.str();
+    }
+
+    void printProfile(const std::map<InstructionPair, size_t>& pairs, const size_t executedInstructions)
+    {
+        std::vector<std::pair<InstructionPair, size_t>> sortedPairs(pairs.begin(), pairs.end());
+        std::sort(sortedPairs.begin(), sortedPairs.end(), [](const auto& pair1, const auto& pair2) { return pair1.second > pair2.second; });
+
+        std::cout << executedInstructions << " instructions profiled" << std::endl;
+        for (size_t i = 0; i < std::min(ProfiledPairs, sortedPairs.size()); i++)
+        {
+            const auto& [pair, count] = sortedPairs[i];
+            std::cout << describe(pair.first) << " " << describe(pair.second) << std::right << std::setw(8) << std::fixed << std::setprecision(2)
+                      << 100.0 * static_cast<double>(count) / static_cast<double>(executedInstructions) << " %" << std::endl;
+        }
+    }
+}
+
+// Compares the throughput of the execution engines on the same ROMs, or profiles the instructions they execute.
+int main(int argc, char* argv[])
+{
+    chip8::benchmark::CommandLineOptions options;
+    clparser::CommandLineParser parser(argc, argv);
+    chip8::Logger logger;
+    int exitCode = chip8::ExitCode::Success;
+
+    try
+    {
+        parser.parse(options);
+        if (options.version())
+        {
+            std::cout << ProgramName << " version " << chip8::metadata::Version << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        if (options.help())
+        {
+            std::cout << options.getHelpMessage(ProgramName) << std::endl;
+            return chip8::ExitCode::Success;
+        }
+
+        logger.setVerbose(options.verbose());
+
+        std::map<InstructionPair, size_t> pairs;
+        size_t profiledInstructions = 0;
+
+        for (const std::filesystem::path& romName : findRoms(options.romName()))
+        {
+            const std::string rom = loadRom(romName);
+
+            try
+            {
+                if (options.profile())
+                {
+                    profiledInstructions += profile(logger, rom, options.instructions(), pairs);
+                    continue;
+                }
+
+                std::cout << romName.filename().string() << std::endl;
+                for (const Engine& engine : Engines)
+                {
+                    const double instructionsPerSecond = measure(logger, rom, engine.engine, options.instructions());
+                    std::cout << "  " << std::left << std::setw(12) << engine.name << std::right << std::setw(10) << std::fixed
+                              << std::setprecision(1) << instructionsPerSecond / 1e6 << " M instructions/s" << std::endl;
+                }
+            }
+            catch (chip8::CpuExecutionException& cpuError)
+            {
+                logger.logError("%s: %s", romName.string().c_str(), cpuError.what());
+                exitCode = chip8::ExitCode::CpuError;
+            }
+        }
+
+        if (options.profile())
+        {
+            printProfile(pairs, profiledInstructions);
+        }
+    }
+    catch (clparser::ArgumentNotFoundException& argNotFound)
+    {
+        logger.logError(argNotFound.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (clparser::ArgumentFormatException& argWrongFormat)
+    {
+        logger.logError(argWrongFormat.what());
+        std::cout << options.getHelpMessage(ProgramName) << std::endl;
+        return chip8::ExitCode::CommandLineArgsParseError;
+    }
+    catch (chip8::RomLoadFailureException& romLoadFailure)
+    {
+        logger.logError(romLoadFailure.what());
+        return chip8::ExitCode::RomLoadFailure;
+    }
+
+    return exitCode;
+}
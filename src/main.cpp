@@ -7,7 +7,12 @@
 #include <cpu/RomLoadFailureException.hpp>
 #include <emulator/AudioInitializationException.hpp>
 #include <emulator/Emulator.hpp>
+#include <emulator/HeadlessEmulator.hpp>
+#include <emulator/InputScript.hpp>
+#include <emulator/InputScriptException.hpp>
 #include <emulator/WindowInitializationException.hpp>
+#include <fstream>
+#include <iomanip>
 #include <logging/Severity.hpp>
 
 #include "CommandLineOptions.hpp"
@@ -15,6 +20,47 @@
 #include "Logger.hpp"
 #include "metadata.hpp"
 
+namespace
+{
+    // Runs the ROM without initializing SDL and prints what it did, e.g. to check on hosts without display that a ROM still draws the
+    // same frame buffer.
+    void runHeadless(const chip8::Logger& logger, const chip8::CommandLineOptions& options)
+    {
+        chip8::InputScript input;
+        if (!options.input().empty())
+        {
+            std::ifstream script(options.input());
+            if (script.fail())
+            {
+                throw chip8::InputScriptException("couldn't open " + options.input());
+            }
+
+            input = chip8::InputScript(script);
+        }
+
+        std::ifstream rom(options.romName(), std::ios::binary);
+        if (rom.fail())
+        {
+            throw chip8::RomLoadFailureException("Couldn't open ROM " + options.romName());
+        }
+
+        chip8::HeadlessEmulator emulator(logger, options.getExecutionEngine(), options.getDisplayMode());
+        emulator.boot(rom, chip8::RandomGenerator(options.getRandomEngine(), options.getSeed()));
+
+        const chip8::HeadlessEmulator::Report report = emulator.run(input, options.clock(), options.frames(), options.instructions(), options.realTime());
+        if (report.waitingForKey)
+        {
+            logger.logWarning("Stopped early: the program waits for a key that the input script doesn't press");
+        }
+
+        std::cout << "instructions: " << report.instructions << std::endl;
+        std::cout << "frames: " << report.frames << " (" << report.drawnFrames << " drawn)" << std::endl;
+        std::cout << "frame buffer hash: " << std::hex << std::setw(16) << std::setfill('0') << report.frameBufferHash << std::dec << std::endl;
+        std::cout << "time: " << std::fixed << std::setprecision(3) << report.seconds << " s (" << std::setprecision(1)
+                  << static_cast<double>(report.instructions) / report.seconds / 1e6 << " M instructions/s)" << std::endl;
+    }
+}
+
 int main(int argc, char* argv[])
 {
     chip8::CommandLineOptions options;
@@ -38,8 +84,15 @@ int main(int argc, char* argv[])
 
         logger.setVerbose(options.verbose());
 
+        if (options.headless())
+        {
+            runHeadless(logger, options);
+            return chip8::ExitCode::Success;
+        }
+
         chip8::Emulator emulator(logger, options.romName());
-        emulator.run(chip8::metadata::ProgramName, chip8::metadata::Version, options.clock());
+        emulator.run(chip8::metadata::ProgramName, chip8::metadata::Version, options.clock(), options.getOverrunPolicy(), options.getExecutionEngine(), options.getTimerMode(),
+                     options.getDisplayMode(), options.getRandomEngine(), options.getSeed(), options.getPalette());
     }
     catch (clparser::ArgumentNotFoundException& argNotFound)
     {
@@ -63,6 +116,11 @@ int main(int argc, char* argv[])
         logger.logError(audioFailure.what());
         return chip8::ExitCode::AudioInitializationFailure;
     }
+    catch (chip8::InputScriptException& inputScriptFailure)
+    {
+        logger.logError(inputScriptFailure.what());
+        return chip8::ExitCode::InputScriptFailure;
+    }
     catch (chip8::RomLoadFailureException& romLoadFailure)
     {
         logger.logError(romLoadFailure.what());
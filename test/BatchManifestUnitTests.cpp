@@ -0,0 +1,41 @@
+#include <batch/BatchManifest.hpp>
+#include <batch/ManifestException.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace chip8::unit_tests
+{
+    TEST(BatchManifestUnitTests, ReadManifest_Jobs_PathsRelativeToDirectory)
+    {
+        std::istringstream manifest("# rom seed input instructions\n"
+                                    "PONG 1 pong.keys 1000\n"
+                                    "\n"
+                                    "/roms/UFO 18446744073709551615 - 5\n");
+        const std::vector<chip8::batch::BatchJob> jobs = chip8::batch::readManifest(manifest, "jobs");
+
+        ASSERT_EQ(jobs.size(), 2u);
+        ASSERT_EQ(jobs[0].rom, std::filesystem::path("jobs") / "PONG");
+        ASSERT_EQ(jobs[0].seed, 1u);
+        ASSERT_EQ(jobs[0].inputScript, std::filesystem::path("jobs") / "pong.keys");
+        ASSERT_EQ(jobs[0].instructions, 1000u);
+        ASSERT_EQ(jobs[1].rom, std::filesystem::path("/roms/UFO"));
+        ASSERT_EQ(jobs[1].seed, 18446744073709551615u);
+        ASSERT_TRUE(jobs[1].inputScript.empty());
+    }
+
+    TEST(BatchManifestUnitTests, ReadManifest_MalformedLine_Throws)
+    {
+        for (const char* line : {"PONG 1 -", "PONG x - 10", "PONG 1 - -10", "PONG 1 - 10 20", "PONG 1 - 10k"})
+        {
+            std::istringstream manifest(line);
+            ASSERT_THROW(chip8::batch::readManifest(manifest, ""), chip8::batch::ManifestException) << line;
+        }
+    }
+
+    TEST(BatchManifestUnitTests, ReadManifest_NoInstructions_Throws)
+    {
+        std::istringstream manifest("PONG 1 - 0");
+
+        ASSERT_THROW(chip8::batch::readManifest(manifest, ""), chip8::batch::ManifestException);
+    }
+}
\ No newline at end of file
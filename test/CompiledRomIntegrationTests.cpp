@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cpu/CompiledRom.hpp>
+#include <cpu/Cpu.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <memory>
+#include <span>
+
+// Built into chip8-aot-test only, with chip8_compiled_rom translated from this ROM by chip8-aot (see builds/cmake/CMakeLists.txt).
+#ifndef CHIP8_AOT_TEST_ROM
+#define CHIP8_AOT_TEST_ROM "../../roms/PONG"
+#endif
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    constexpr size_t Frames = 600;
+    constexpr size_t InstructionsPerFrame = 1000;
+
+    size_t nativeInstructions = 0;
+
+    // Runs the generated code, counting the instructions it executes.
+    void runCounted(chip8::CompiledRom::State& state)
+    {
+        const int64_t budget = state.budget;
+        chip8_compiled_rom.run(state);
+        nativeInstructions += static_cast<size_t>(budget - state.budget);
+    }
+
+    const chip8::CompiledRom countedRom{chip8_compiled_rom.image, chip8_compiled_rom.imageSize, &runCounted};
+
+    struct Machine
+    {
+        Machine(const logging::Logger& logger, const chip8::CompiledRom* compiledRom)
+            : gpu(logger)
+            , soundTimer(frameClock)
+            , delayTimer(frameClock)
+            , cpu(logger, gpu, soundTimer, delayTimer, chip8::ExecutionEngine::Interpreter, chip8::RandomGenerator(chip8::RandomEngine::Xorshift))
+        {
+            cpu.setCompiledRom(compiledRom);
+            std::ifstream rom(CHIP8_AOT_TEST_ROM, std::ios::binary);
+            cpu.boot(rom);
+        }
+
+        // Runs a frame with the key of the frame pressed, as the integration tests of chip8-test do.
+        void runFrame(const size_t frame)
+        {
+            const auto key = static_cast<chip8::Key>(frame % 16);
+            cpu.onKeyPressed(key);
+            cpu.run(InstructionsPerFrame);
+            cpu.onKeyReleased(key);
+            frameClock.tick();
+        }
+
+        chip8::Gpu gpu;
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer;
+        chip8::FrameTimer delayTimer;
+        chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer> cpu;
+    };
+}
+
+namespace chip8::integration_tests
+{
+    TEST(CompiledRomIntegrationTests, translated_rom_matches_interpreter)
+    {
+        SilentLogger logger;
+        const auto reference = std::make_unique<Machine>(logger, nullptr);
+        const auto compiled = std::make_unique<Machine>(logger, &countedRom);
+        nativeInstructions = 0;
+
+        for (size_t frame = 0; frame < Frames; frame++)
+        {
+            reference->runFrame(frame);
+            compiled->runFrame(frame);
+
+            const auto& expected = reference->cpu.getRegisters();
+            const auto& actual = compiled->cpu.getRegisters();
+            ASSERT_EQ(actual.V, expected.V) << "frame " << frame;
+            ASSERT_EQ(*actual.I, *expected.I) << "frame " << frame;
+            ASSERT_EQ(*actual.PC, *expected.PC) << "frame " << frame;
+            ASSERT_EQ(*actual.SP, *expected.SP) << "frame " << frame;
+            const std::span<const uint64_t> frameBuffer = compiled->gpu.getFrameBuffer();
+            ASSERT_TRUE(std::equal(frameBuffer.begin(), frameBuffer.end(), reference->gpu.getFrameBuffer().begin())) << "frame " << frame;
+        }
+
+        EXPECT_GT(nativeInstructions, Frames * InstructionsPerFrame / 2);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include <array>
+#include <cpu/Cpu.hpp>
+#include <cpu/CpuExecutionException.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/LockstepCpu.hpp>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ROMs of the repository, relative to builds/cmake and builds/vs.
+#ifndef CHIP8_ROMS_DIRECTORY
+#define CHIP8_ROMS_DIRECTORY "../../roms/"
+#endif
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    constexpr size_t Frames = 300;
+    constexpr size_t InstructionsPerFrame = 1000;
+
+    struct MachineState
+    {
+        std::array<uint8_t, 16> V;
+        uint16_t I;
+        uint16_t PC;
+        uint8_t SP;
+        std::vector<uint64_t> frameBuffer;
+        std::optional<chip8::CpuErrorCode> error;
+    };
+
+    std::string readRom(const std::filesystem::path& path)
+    {
+        std::ifstream romFile(path, std::ios::binary);
+        std::ostringstream rom;
+        rom << romFile.rdbuf();
+        return rom.str();
+    }
+
+    // Runs the ROM pressing the keys one after the other, one per frame from firstKey on, as chip8-benchmark does.
+    template <typename BoundsPolicy>
+    MachineState runRom(const std::string& rom, const uint64_t seed = chip8::RandomGenerator::DefaultSeed, const size_t firstKey = 0)
+    {
+        SilentLogger logger;
+        chip8::Gpu gpu(logger);
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer(frameClock);
+        chip8::FrameTimer delayTimer(frameClock);
+        chip8::BasicCpu<chip8::IGpu, chip8::ITimer, BoundsPolicy> cpu(
+            logger, gpu, soundTimer, delayTimer, chip8::ExecutionEngine::Interpreter, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, seed));
+
+        std::istringstream romData(rom);
+        cpu.boot(romData);
+
+        for (size_t frame = 0; frame < Frames; frame++)
+        {
+            const auto key = static_cast<chip8::Key>((firstKey + frame) % 16);
+            cpu.onKeyPressed(key);
+            cpu.run(InstructionsPerFrame);
+            cpu.onKeyReleased(key);
+            frameClock.tick();
+        }
+
+        auto& registers = cpu.getRegisters();
+        const std::span<const uint64_t> frameBuffer = cpu.getFrameBuffer();
+        return {registers.V, *registers.I, *registers.PC, *registers.SP, {frameBuffer.begin(), frameBuffer.end()}};
+    }
+
+    // Machine of runRom with its own timers, to run it in several steps.
+    template <typename BoundsPolicy>
+    struct Machine
+    {
+        Machine(const logging::Logger& logger, const chip8::ExecutionEngine engine, const uint64_t seed)
+            : gpu(logger)
+            , soundTimer(frameClock)
+            , delayTimer(frameClock)
+            , cpu(logger, gpu, soundTimer, delayTimer, engine, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, seed))
+        {
+        }
+
+        // Runs frames [firstFrame, firstFrame + frames) as runRom does.
+        void run(const size_t firstFrame, const size_t frames)
+        {
+            for (size_t frame = firstFrame; frame < firstFrame + frames; frame++)
+            {
+                const auto key = static_cast<chip8::Key>(frame % 16);
+                cpu.onKeyPressed(key);
+                cpu.run(InstructionsPerFrame);
+                cpu.onKeyReleased(key);
+                frameClock.tick();
+            }
+        }
+
+        MachineState getState()
+        {
+            auto& registers = cpu.getRegisters();
+            const std::span<const uint64_t> frameBuffer = cpu.getFrameBuffer();
+            return {registers.V, *registers.I, *registers.PC, *registers.SP, {frameBuffer.begin(), frameBuffer.end()}};
+        }
+
+        chip8::Gpu gpu;
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer;
+        chip8::FrameTimer delayTimer;
+        chip8::BasicCpu<chip8::IGpu, chip8::ITimer, BoundsPolicy> cpu;
+    };
+
+    // Same as runRom for every lane, lane i using seed i and pressing the keys from key i on.
+    std::vector<MachineState> runLockstep(const std::string& rom, const size_t lanes, const chip8::SimdLevel level)
+    {
+        SilentLogger logger;
+        chip8::LockstepCpu cpu(logger, lanes, level);
+        std::vector<uint64_t> seeds(lanes);
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            seeds[lane] = lane;
+        }
+
+        std::istringstream romData(rom);
+        cpu.boot(romData, seeds);
+
+        for (size_t frame = 0; frame < Frames; frame++)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                cpu.onKeyPressed(lane, static_cast<chip8::Key>((lane + frame) % 16));
+            }
+
+            cpu.run(InstructionsPerFrame);
+
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                cpu.onKeyReleased(lane, static_cast<chip8::Key>((lane + frame) % 16));
+            }
+            cpu.tickTimers();
+        }
+
+        std::vector<MachineState> states(lanes);
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            MachineState& state = states[lane];
+            for (size_t index = 0; index < state.V.size(); index++)
+            {
+                state.V[index] = cpu.getV(lane, index);
+            }
+            state.I = cpu.getI(lane);
+            state.PC = cpu.getPC(lane);
+            state.SP = cpu.getSP(lane);
+            const std::span<const uint64_t> frameBuffer = cpu.getFrameBuffer(lane);
+            state.frameBuffer.assign(frameBuffer.begin(), frameBuffer.end());
+            state.error = cpu.getError(lane);
+        }
+
+        return states;
+    }
+}
+
+namespace chip8::integration_tests
+{
+    // ROMs that never go out of bounds must run the same whether addresses are checked or wrapped.
+    TEST(CpuIntegrationTests, wrapped_bounds_match_checked_bounds_on_well_behaved_roms)
+    {
+        size_t wellBehavedRoms = 0;
+
+        for (const auto& entry : std::filesystem::directory_iterator(CHIP8_ROMS_DIRECTORY))
+        {
+            const std::string rom = readRom(entry.path());
+
+            MachineState checked;
+            try
+            {
+                checked = runRom<chip8::CheckedBounds>(rom);
+            }
+            catch (chip8::CpuExecutionException&)
+            {
+                continue;
+            }
+
+            const MachineState wrapped = runRom<chip8::WrappedBounds>(rom);
+            const std::string romName = entry.path().filename().string();
+            EXPECT_EQ(checked.V, wrapped.V) << romName;
+            EXPECT_EQ(checked.I, wrapped.I) << romName;
+            EXPECT_EQ(checked.PC, wrapped.PC) << romName;
+            EXPECT_EQ(checked.SP, wrapped.SP) << romName;
+            EXPECT_EQ(checked.frameBuffer, wrapped.frameBuffer) << romName;
+            wellBehavedRoms++;
+        }
+
+        EXPECT_GT(wellBehavedRoms, 0);
+    }
+
+    // Every lane must end in the state of a Cpu run alone with its seed and keys, or stop on the error the Cpu throws.
+    TEST(CpuIntegrationTests, lockstep_lanes_match_cpu)
+    {
+        constexpr size_t Lanes = 40;
+
+        for (const auto& entry : std::filesystem::directory_iterator(CHIP8_ROMS_DIRECTORY))
+        {
+            const std::string rom = readRom(entry.path());
+            std::vector<std::optional<MachineState>> expectedLanes(Lanes);
+            for (size_t lane = 0; lane < Lanes; lane++)
+            {
+                try
+                {
+                    expectedLanes[lane] = runRom<chip8::WrappedBounds>(rom, lane, lane);
+                }
+                catch (chip8::CpuExecutionException&)
+                {
+                }
+            }
+
+            for (const chip8::SimdLevel level : {chip8::SimdLevel::None, chip8::SimdLevel::Avx2})
+            {
+                if (level > chip8::getSimdLevel())
+                {
+                    continue;
+                }
+
+                const std::vector<MachineState> lanes = runLockstep(rom, Lanes, level);
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    const std::string laneName = entry.path().filename().string() + " lane " + std::to_string(lane);
+                    const std::optional<MachineState>& expected = expectedLanes[lane];
+                    EXPECT_EQ(lanes[lane].error.has_value(), !expected.has_value()) << laneName;
+
+                    if (expected)
+                    {
+                        EXPECT_EQ(expected->V, lanes[lane].V) << laneName;
+                        EXPECT_EQ(expected->I, lanes[lane].I) << laneName;
+                        EXPECT_EQ(expected->PC, lanes[lane].PC) << laneName;
+                        EXPECT_EQ(expected->SP, lanes[lane].SP) << laneName;
+                        EXPECT_EQ(expected->frameBuffer, lanes[lane].frameBuffer) << laneName;
+                    }
+                }
+            }
+        }
+    }
+
+    // A snapshot taken halfway must replay the second half exactly, restored into the same CPU or into another one running another engine,
+    // whose decoded instructions and native code were made for another seed.
+    TEST(CpuIntegrationTests, snapshot_replays_the_rest_of_the_run)
+    {
+        constexpr size_t HalfFrames = Frames / 2;
+        SilentLogger logger;
+
+        for (const auto& entry : std::filesystem::directory_iterator(CHIP8_ROMS_DIRECTORY))
+        {
+            const std::string rom = readRom(entry.path());
+            const std::string romName = entry.path().filename().string();
+
+            for (const chip8::ExecutionEngine engine : {chip8::ExecutionEngine::Interpreter,
+                                                        chip8::ExecutionEngine::CachedInterpreter,
+                                                        chip8::ExecutionEngine::BasicBlock,
+                                                        chip8::ExecutionEngine::Threaded,
+                                                        chip8::ExecutionEngine::Jit})
+            {
+                Machine<chip8::WrappedBounds> machine(logger, engine, 1);
+                std::istringstream romData(rom);
+                machine.cpu.boot(romData);
+                machine.run(0, HalfFrames);
+
+                const chip8::CpuSnapshot snapshot = machine.cpu.save();
+                machine.run(HalfFrames, HalfFrames);
+                const MachineState expected = machine.getState();
+
+                machine.cpu.restore(snapshot);
+                machine.run(HalfFrames, HalfFrames);
+                const MachineState replayed = machine.getState();
+
+                Machine<chip8::WrappedBounds> other(logger, chip8::ExecutionEngine::Threaded, 2);
+                romData.clear();
+                other.cpu.boot(romData);
+                other.run(0, HalfFrames / 2);
+                other.cpu.restore(snapshot);
+                other.run(HalfFrames, HalfFrames);
+                const MachineState restoredElsewhere = other.getState();
+
+                for (const MachineState& state : {replayed, restoredElsewhere})
+                {
+                    EXPECT_EQ(expected.V, state.V) << romName;
+                    EXPECT_EQ(expected.I, state.I) << romName;
+                    EXPECT_EQ(expected.PC, state.PC) << romName;
+                    EXPECT_EQ(expected.SP, state.SP) << romName;
+                    EXPECT_EQ(expected.frameBuffer, state.frameBuffer) << romName;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
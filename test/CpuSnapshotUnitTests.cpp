@@ -0,0 +1,178 @@
+#include <cpu/Cpu.hpp>
+#include <cpu/CpuSnapshot.hpp>
+#include <cpu/FrameClock.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <cpu/Gpu.hpp>
+#include <cpu/SnapshotFormatException.hpp>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    // jp 0x204; (0x202) 0000; ld v2, 1; jp 0x206
+    const std::string LoadV2("\x12\x04\x00\x00\x62\x01\x12\x06", 8);
+    // rnd v0, 0xf; ld dt, v0; ld f, v0; drw v1, v1, 5; jp 0x208
+    const std::string DrawRandomDigit("\xC0\x0F\xF0\x15\xF0\x29\xD1\x15\x12\x08", 10);
+}
+
+namespace chip8::unit_tests
+{
+    class CpuSnapshotUnitTests : public ::testing::TestWithParam<chip8::ExecutionEngine>
+    {
+      protected:
+        void boot(const std::string& rom)
+        {
+            std::istringstream romData(rom);
+            cpu.boot(romData);
+        }
+
+        SilentLogger logger;
+        chip8::Gpu gpu{logger};
+        chip8::FrameClock frameClock;
+        chip8::FrameTimer soundTimer{frameClock};
+        chip8::FrameTimer delayTimer{frameClock};
+        chip8::BasicCpu<chip8::Gpu, chip8::FrameTimer> cpu{logger, gpu, soundTimer, delayTimer, GetParam()};
+    };
+
+    TEST_P(CpuSnapshotUnitTests, Restore_AfterRun_RestoresMachineState)
+    {
+        boot(DrawRandomDigit);
+        cpu.onKeyPressed(chip8::Key::Num5);
+        const chip8::CpuSnapshot snapshot = cpu.save();
+        cpu.onKeyReleased(chip8::Key::Num5);
+        cpu.run(5);
+        const chip8::CpuSnapshot afterRun = cpu.save();
+        frameClock.tick();
+
+        cpu.restore(snapshot);
+        const chip8::CpuSnapshot restored = cpu.save();
+        EXPECT_EQ(std::memcmp(&restored, &snapshot, sizeof(snapshot)), 0);
+
+        cpu.onKeyReleased(chip8::Key::Num5);
+        cpu.run(5);
+        const chip8::CpuSnapshot rerun = cpu.save();
+        EXPECT_EQ(std::memcmp(&rerun, &afterRun, sizeof(afterRun)), 0);
+        EXPECT_NE(afterRun.delayTimer, 0);
+        EXPECT_NE(afterRun.frameBuffer, snapshot.frameBuffer);
+    }
+
+    TEST_P(CpuSnapshotUnitTests, Restore_DifferentCode_ExecutesTheRestoredCode)
+    {
+        boot(LoadV2);
+        cpu.run(3);
+        ASSERT_EQ(cpu.getRegisters().V[2], 1);
+
+        chip8::CpuSnapshot snapshot = cpu.save();
+        snapshot.memory[0x205] = 2;
+        snapshot.PC = 0x200;
+        cpu.restore(snapshot);
+        cpu.run(3);
+
+        EXPECT_EQ(cpu.getRegisters().V[2], 2);
+    }
+
+    TEST_P(CpuSnapshotUnitTests, Restore_RegistersOutOfBounds_ThrowsAndKeepsMachineState)
+    {
+        boot(LoadV2);
+        cpu.run(3);
+        const chip8::CpuSnapshot before = cpu.save();
+
+        chip8::CpuSnapshot snapshot = before;
+        snapshot.memory[0x205] = 2;
+        snapshot.V[2] = 3;
+        snapshot.PC = chip8::Registers::MemorySize + 1;
+        EXPECT_THROW(cpu.restore(snapshot), std::invalid_argument);
+        snapshot.PC = before.PC;
+        snapshot.I = chip8::Registers::MemorySize + 1;
+        EXPECT_THROW(cpu.restore(snapshot), std::invalid_argument);
+        snapshot.I = before.I;
+        snapshot.SP = chip8::Registers::StackSize + 1;
+        EXPECT_THROW(cpu.restore(snapshot), std::invalid_argument);
+
+        const chip8::CpuSnapshot after = cpu.save();
+        EXPECT_EQ(std::memcmp(&after, &before, sizeof(before)), 0);
+    }
+
+    TEST_P(CpuSnapshotUnitTests, Save_StandardRandomEngine_Throws)
+    {
+        boot(LoadV2);
+        cpu.setRandomGenerator(chip8::RandomGenerator(chip8::RandomEngine::Standard));
+
+        EXPECT_THROW(cpu.save(), std::logic_error);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Engines,
+                             CpuSnapshotUnitTests,
+                             ::testing::Values(chip8::ExecutionEngine::Interpreter,
+                                               chip8::ExecutionEngine::CachedInterpreter,
+                                               chip8::ExecutionEngine::BasicBlock,
+                                               chip8::ExecutionEngine::Threaded,
+                                               chip8::ExecutionEngine::Jit));
+
+    TEST(CpuSnapshotFileUnitTests, ReadSnapshot_Written_EqualsOriginal)
+    {
+        chip8::CpuSnapshot snapshot{};
+        snapshot.randomState = 0x0123456789ABCDEF;
+        snapshot.frameBuffer[31] = 0x8000000000000001;
+        snapshot.memory[0xFFF] = 0x42;
+        snapshot.PC = 0x2FE;
+        snapshot.keys = 0x8001;
+        snapshot.state = static_cast<uint8_t>(chip8::CpuState::WaitForKey);
+
+        std::stringstream file;
+        chip8::writeSnapshot(file, snapshot);
+        const chip8::CpuSnapshot read = chip8::readSnapshot(file);
+
+        EXPECT_EQ(std::memcmp(&read, &snapshot, sizeof(snapshot)), 0);
+    }
+
+    TEST(CpuSnapshotFileUnitTests, ReadSnapshot_IAtEndOfMemory_EqualsOriginal)
+    {
+        chip8::CpuSnapshot snapshot{};
+        snapshot.I = 0x1000; // Reachable with CheckedBounds, e.g. after Fx1E
+
+        std::stringstream file;
+        chip8::writeSnapshot(file, snapshot);
+        const chip8::CpuSnapshot read = chip8::readSnapshot(file);
+
+        EXPECT_EQ(read.I, 0x1000);
+    }
+
+    TEST(CpuSnapshotFileUnitTests, ReadSnapshot_OtherVersion_Throws)
+    {
+        std::stringstream file;
+        chip8::writeSnapshot(file, chip8::CpuSnapshot{});
+        std::string data = file.str();
+        data[4] = static_cast<char>(chip8::CpuSnapshot::Version + 1);
+
+        std::istringstream otherVersion(data);
+        EXPECT_THROW(chip8::readSnapshot(otherVersion), chip8::SnapshotFormatException);
+    }
+
+    TEST(CpuSnapshotFileUnitTests, ReadSnapshot_Truncated_Throws)
+    {
+        std::stringstream file;
+        chip8::writeSnapshot(file, chip8::CpuSnapshot{});
+        std::istringstream truncated(file.str().substr(0, 100));
+
+        EXPECT_THROW(chip8::readSnapshot(truncated), chip8::SnapshotFormatException);
+    }
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
+#include <cpu/CompiledRom.hpp>
 #include <cpu/Cpu.hpp>
 #include <cpu/CpuExecutionException.hpp>
+#include <cpu/ExecutionEngine.hpp>
 #include <cpu/IGpu.hpp>
 #include <cpu/ITimer.hpp>
+#include <cpu/RandomGenerator.hpp>
 #include <cpu/Registers.hpp>
 #include <functional>
 #include <gmock/gmock.h>
@@ -15,8 +18,11 @@ class Gpu : public chip8::IGpu
 {
   public:
     MOCK_METHOD(void, clear, ());
-    MOCK_METHOD(bool, setSprite, (const size_t x, const size_t y, const std::vector<uint8_t>& sprite));
-    MOCK_METHOD(const std::vector<bool>&, getFrameBuffer, (), (const));
+    MOCK_METHOD(bool, setSprite, (const size_t x, const size_t y, const std::span<const uint8_t> sprite));
+    MOCK_METHOD(std::span<const uint64_t>, getFrameBuffer, (), (const));
+    MOCK_METHOD(void, setFrameBuffer, (const std::span<const uint64_t> frameBuffer));
+    MOCK_METHOD(uint32_t, getDirtyRows, (), (const));
+    MOCK_METHOD(void, onDrawComplete, ());
     MOCK_METHOD(size_t, getWidth, ());
     MOCK_METHOD(size_t, getHeight, ());
 };
@@ -66,15 +72,62 @@ void initTest(uint8_t byte1, uint8_t byte2, chip8::Cpu& cpu)
     cpu.boot(s);
 }
 
+void initTest(const std::vector<uint8_t>& program, chip8::Cpu& cpu)
+{
+    std::stringstream s;
+    s.write(reinterpret_cast<const char*>(program.data()), program.size());
+    cpu.boot(s);
+}
+
+// Hand-written translation of the first block of the program below, as chip8-aot would generate it.
+namespace compiled_rom
+{
+    const std::vector<uint8_t> program{0x71, 0x01,  // add v1, 1
+                                       0xa2, 0x00,  // ld I, 0x200
+                                       0x60, 0x72,  // ld v0, 0x72
+                                       0xf0, 0x55,  // ld [I], v0 (turns "add v1, 1" into "add v2, 1")
+                                       0x12, 0x00}; // jp 0x200
+
+    size_t executedBlocks = 0;
+
+    void run(chip8::CompiledRom::State& state)
+    {
+        if (state.PC != 0x200 || state.budget < 1 || state.modified[0x200])
+        {
+            return;
+        }
+
+        state.budget -= 1;
+        state.V[1] = static_cast<uint8_t>(state.V[1] + 1);
+        state.PC = 0x202;
+        executedBlocks++;
+    }
+
+    const chip8::CompiledRom compiledRom{program.data(), program.size(), &run};
+}
+
 namespace chip8::unit_tests
 {
-    TEST(CpuUnitTests, sys_addr_throws_exception)
+    // Every test runs once per execution engine, as all engines must behave the same.
+    class CpuUnitTests : public ::testing::TestWithParam<chip8::ExecutionEngine>
+    {
+    };
+
+    INSTANTIATE_TEST_SUITE_P(ExecutionEngines,
+                             CpuUnitTests,
+                             ::testing::Values(chip8::ExecutionEngine::Interpreter,
+                                               chip8::ExecutionEngine::CachedInterpreter,
+                                               chip8::ExecutionEngine::BasicBlock,
+                                               chip8::ExecutionEngine::Threaded,
+                                               chip8::ExecutionEngine::Jit));
+
+    TEST_P(CpuUnitTests, sys_addr_throws_exception)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
 
         initTest(0x00, 0x00, cpu); // SYS 0
@@ -90,13 +143,13 @@ namespace chip8::unit_tests
         }
     }
 
-    TEST(CpuUnitTests, cls_executes_successfuly)
+    TEST_P(CpuUnitTests, cls_executes_successfuly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
 
         initTest(0x00, 0xe0, cpu); // cls
@@ -105,13 +158,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, ret_executes_successfuly)
+    TEST_P(CpuUnitTests, ret_executes_successfuly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x00, 0xee, cpu); // ret
         registers.SP = 2;
@@ -120,13 +173,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.SP, 0x00);
     }
 
-    TEST(CpuUnitTests, ret_executes_stack_underflow)
+    TEST_P(CpuUnitTests, ret_executes_stack_underflow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x00, 0xee, cpu); // ret
 
@@ -141,26 +194,26 @@ namespace chip8::unit_tests
         }
     }
 
-    TEST(CpuUnitTests, jp_addr_executes_successfuly)
+    TEST_P(CpuUnitTests, jp_addr_executes_successfuly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x15, 0x67, cpu); // jp 0x567
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x567);
     }
 
-    TEST(CpuUnitTests, call_addr_executes_successfuly)
+    TEST_P(CpuUnitTests, call_addr_executes_successfuly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x25, 0x67, cpu); // call 0x567
         cpu.runClockCycle();
@@ -168,13 +221,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.SP, 2);
     }
 
-    TEST(CpuUnitTests, call_addr_executes_stack_overflow)
+    TEST_P(CpuUnitTests, call_addr_executes_stack_overflow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x25, 0x67, cpu); // call 0x567
         registers.SP = 63;
@@ -190,65 +243,65 @@ namespace chip8::unit_tests
         }
     }
 
-    TEST(CpuUnitTests, se_vx_byte_not_skip)
+    TEST_P(CpuUnitTests, se_vx_byte_not_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x34, 0x56, cpu); // se v4, 0x56
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, se_vx_byte_skip)
+    TEST_P(CpuUnitTests, se_vx_byte_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x34, 0x00, cpu); // se v4, 0x00
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, sne_vx_byte_not_skip)
+    TEST_P(CpuUnitTests, sne_vx_byte_not_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x44, 0x00, cpu); // sne v4, 0x00
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, sne_vx_byte_skip)
+    TEST_P(CpuUnitTests, sne_vx_byte_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x44, 0x56, cpu); // sne v4, 0x56
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, se_vx_vy_not_skip)
+    TEST_P(CpuUnitTests, se_vx_vy_not_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x54, 0x50, cpu); // se v4, v5
         registers.V[5] = 1;
@@ -256,26 +309,26 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, se_vx_vy_byte_skip)
+    TEST_P(CpuUnitTests, se_vx_vy_byte_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x45, 0x55, cpu); // se v4, v5
         cpu.runClockCycle();
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, ld_vx_byte_executes_correctly)
+    TEST_P(CpuUnitTests, ld_vx_byte_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x62, 0x54, cpu); // ld V2, 0x54
         cpu.runClockCycle();
@@ -283,13 +336,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(registers.V[2], 0x54);
     }
 
-    TEST(CpuUnitTests, add_vx_byte_executes_correctly)
+    TEST_P(CpuUnitTests, add_vx_byte_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x72, 13, cpu); // add V2, 13
         registers.V[2] = 10;
@@ -299,13 +352,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, ld_vx_vy_executes_correctly)
+    TEST_P(CpuUnitTests, ld_vx_vy_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x30, cpu); // ld v2, v3
         registers.V[3] = 10;
@@ -315,13 +368,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, or_vx_vy_executes_correctly)
+    TEST_P(CpuUnitTests, or_vx_vy_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x31, cpu); // or v2, v3
         registers.V[2] = 0x0f;
@@ -332,13 +385,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, and_vx_vy_executes_correctly)
+    TEST_P(CpuUnitTests, and_vx_vy_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x32, cpu); // and v2, v3
         registers.V[2] = 0x0f;
@@ -349,13 +402,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, xor_vx_vy_executes_correctly)
+    TEST_P(CpuUnitTests, xor_vx_vy_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x33, cpu); // xor v2, v3
         registers.V[2] = 0x0f;
@@ -366,13 +419,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, xor_vx_vy_executes_correctly_no_carry)
+    TEST_P(CpuUnitTests, xor_vx_vy_executes_correctly_no_carry)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x34, cpu); // add v2, v3
         registers.V[2] = 10;
@@ -383,13 +436,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, sub_vx_vy_executes_correctly_no_borrow)
+    TEST_P(CpuUnitTests, sub_vx_vy_executes_correctly_no_borrow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x35, cpu); // sub v2, v3
         registers.V[2] = 30;
@@ -400,13 +453,13 @@ namespace chip8::unit_tests
         EXPECT_TRUE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, sub_vx_vy_executes_correctly_borrow)
+    TEST_P(CpuUnitTests, sub_vx_vy_executes_correctly_borrow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x35, cpu); // sub v2, v3
         const uint8_t v2 = 20;
@@ -420,13 +473,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, shr_vx_vy_even_executes_correctly_vf_not_set)
+    TEST_P(CpuUnitTests, shr_vx_vy_even_executes_correctly_vf_not_set)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x06, cpu); // shr v2
         registers.V[2] = 0b00000010;
@@ -436,13 +489,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, shr_vx_vy_odd_executes_correctly_vf_set)
+    TEST_P(CpuUnitTests, shr_vx_vy_odd_executes_correctly_vf_set)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x06, cpu); // shr v2
         registers.V[2] = 0b00000101;
@@ -452,13 +505,13 @@ namespace chip8::unit_tests
         EXPECT_TRUE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, subn_vx_vy_executes_correctly_no_borrow)
+    TEST_P(CpuUnitTests, subn_vx_vy_executes_correctly_no_borrow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x37, cpu); // subn v2, v3
         registers.V[2] = 20;
@@ -469,13 +522,13 @@ namespace chip8::unit_tests
         EXPECT_TRUE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, subn_vx_vy_executes_correctly_borrow)
+    TEST_P(CpuUnitTests, subn_vx_vy_executes_correctly_borrow)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x37, cpu); // subn v2, v3
         const uint8_t v2 = 30;
@@ -489,13 +542,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, shl_vx_vy_first_bit_zero_executes_correctly_vf_not_set)
+    TEST_P(CpuUnitTests, shl_vx_vy_first_bit_zero_executes_correctly_vf_not_set)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x0e, cpu); // shl v2
         registers.V[2] = 0b01000011;
@@ -505,13 +558,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, shl_vx_vy_first_bit_one_executes_correctly_vf_set)
+    TEST_P(CpuUnitTests, shl_vx_vy_first_bit_one_executes_correctly_vf_set)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x82, 0x0e, cpu); // shl v2
         registers.V[2] = 0b10000010;
@@ -521,13 +574,13 @@ namespace chip8::unit_tests
         EXPECT_TRUE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, sne_vx_vy_skip)
+    TEST_P(CpuUnitTests, sne_vx_vy_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x92, 0x30, cpu); // sne v2
         registers.V[2] = 10;
@@ -536,13 +589,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, sne_vx_vy_no_skip)
+    TEST_P(CpuUnitTests, sne_vx_vy_no_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0x92, 0x30, cpu); // sne v2
         registers.V[2] = 10;
@@ -551,13 +604,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, ld_i_addr_executes_correctly)
+    TEST_P(CpuUnitTests, ld_i_addr_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xa1, 0x23, cpu); // ld I, 0x123
         cpu.runClockCycle();
@@ -565,13 +618,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.I, 0x123);
     }
 
-    TEST(CpuUnitTests, jp_v0_addr_executes_correctly)
+    TEST_P(CpuUnitTests, jp_v0_addr_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xb1, 0x23, cpu); // jp v0, 0x123
         registers.V[0] = 0x30;
@@ -579,15 +632,43 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x123 + 0x30);
     }
 
-    // Skipping RND instruction as it is not a good practice to test random generation in a non-determinstic way (not worth).
+    TEST_P(CpuUnitTests, rnd_vx_byte_same_seed_generates_same_numbers)
+    {
+        const std::vector<uint8_t> program = {
+            0xc0, 0xff, // rnd v0, 0xff
+            0xc1, 0xff, // rnd v1, 0xff
+            0xc2, 0xff, // rnd v2, 0xff
+            0xc3, 0x0f, // rnd v3, 0x0f
+        };
 
-    TEST(CpuUnitTests, drw_vx_vy_nibble_executes_correctly)
+        for (const chip8::RandomEngine randomEngine : {chip8::RandomEngine::Xorshift, chip8::RandomEngine::Standard})
+        {
+            Logger logger;
+            Gpu gpu;
+            Timer soundTimer;
+            Timer delayTimer;
+            chip8::Cpu cpu1(logger, gpu, soundTimer, delayTimer, GetParam(), chip8::RandomGenerator(randomEngine, 42));
+            chip8::Cpu cpu2(logger, gpu, soundTimer, delayTimer, GetParam(), chip8::RandomGenerator(randomEngine, 42));
+            initTest(program, cpu1);
+            initTest(program, cpu2);
+            cpu1.run(program.size() / 2);
+            cpu2.run(program.size() / 2);
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                EXPECT_EQ(cpu1.getRegisters().V[i], cpu2.getRegisters().V[i]);
+            }
+            EXPECT_LE(cpu1.getRegisters().V[3], 0x0f);
+        }
+    }
+
+    TEST_P(CpuUnitTests, drw_vx_vy_nibble_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xd1, 0x25, cpu); // drw v1, v2, 5
         registers.V[1] = 60;
@@ -600,13 +681,13 @@ namespace chip8::unit_tests
         EXPECT_FALSE(registers.V[0xf]);
     }
 
-    TEST(CpuUnitTests, skp_vx_skip)
+    TEST_P(CpuUnitTests, skp_vx_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xe2, 0x9e, cpu); // skp v2
         registers.V[2] = static_cast<uint8_t>(Key::DigitC);
@@ -615,13 +696,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, skp_vx_no_skip)
+    TEST_P(CpuUnitTests, skp_vx_no_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xe2, 0x9e, cpu); // skp v2
         registers.V[2] = static_cast<uint8_t>(Key::DigitD);
@@ -630,13 +711,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, sknp_vx_skip)
+    TEST_P(CpuUnitTests, sknp_vx_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xe2, 0xa1, cpu); // sknp v2
         registers.V[2] = static_cast<uint8_t>(Key::DigitC);
@@ -645,13 +726,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x204);
     }
 
-    TEST(CpuUnitTests, sknp_vx_no_skip)
+    TEST_P(CpuUnitTests, sknp_vx_no_skip)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xe2, 0xa1, cpu); // sknp v2
         registers.V[2] = static_cast<uint8_t>(Key::DigitC);
@@ -660,13 +741,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, ld_vx_dt_executes_correctly)
+    TEST_P(CpuUnitTests, ld_vx_dt_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x07, cpu); // ld v2, DT
         delayTimer.setValue(50);
@@ -675,13 +756,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(registers.V[2], 50);
     }
 
-    TEST(CpuUnitTests, ld_vx_k_executes_correctly)
+    TEST_P(CpuUnitTests, ld_vx_k_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x0a, cpu); // ld v2, K
         cpu.onKeyPressed(Key::Num3);
@@ -690,13 +771,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(registers.V[2], static_cast<uint8_t>(Key::Num3));
     }
 
-    TEST(CpuUnitTests, ld_vx_k_executes_correctly_two_attempts)
+    TEST_P(CpuUnitTests, ld_vx_k_executes_correctly_two_attempts)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x0a, cpu); // ld v2, K
         cpu.runClockCycle();
@@ -707,13 +788,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(registers.V[2], static_cast<uint8_t>(Key::Num3));
     }
 
-    TEST(CpuUnitTests, ld_dt_vx_executes_correctly)
+    TEST_P(CpuUnitTests, ld_dt_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x15, cpu); // ld DT, v2
         registers.V[2] = 50;
@@ -722,13 +803,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(delayTimer.getValue(), 50);
     }
 
-    TEST(CpuUnitTests, ld_st_vx_executes_correctly)
+    TEST_P(CpuUnitTests, ld_st_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x18, cpu); // ld ST, v2
         registers.V[2] = 50;
@@ -737,13 +818,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(soundTimer.getValue(), 50);
     }
 
-    TEST(CpuUnitTests, add_i_vx_executes_correctly)
+    TEST_P(CpuUnitTests, add_i_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x1e, cpu); // add I, V2
         registers.V[2] = 0x30;
@@ -753,13 +834,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.I, 0x100 + 0x30);
     }
 
-    TEST(CpuUnitTests, ld_f_vx_executes_correctly)
+    TEST_P(CpuUnitTests, ld_f_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x29, cpu); // ld F, vx
         registers.V[2] = 0xa;
@@ -768,13 +849,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.I, 0xa * 5);
     }
 
-    TEST(CpuUnitTests, ld_b_vx_executes_correctly)
+    TEST_P(CpuUnitTests, ld_b_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf2, 0x33, cpu); // ld B, v2
         registers.V[2] = 123;
@@ -782,13 +863,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.PC, 0x202);
     }
 
-    TEST(CpuUnitTests, ld_ivalue_vx_executes_correctly)
+    TEST_P(CpuUnitTests, ld_ivalue_vx_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf4, 0x55, cpu); // ld [I], v4
         registers.I = 10;
@@ -797,13 +878,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.I, 10 + 5);
     }
 
-    TEST(CpuUnitTests, ld_vx_ivalue_executes_correctly)
+    TEST_P(CpuUnitTests, ld_vx_ivalue_executes_correctly)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xf4, 0x65, cpu); // ld v4, [I]
         registers.I = 10;
@@ -812,13 +893,13 @@ namespace chip8::unit_tests
         EXPECT_EQ(*registers.I, 10 + 5);
     }
 
-    TEST(CpuUnitTests, unsupported_instruction_throws)
+    TEST_P(CpuUnitTests, unsupported_instruction_throws)
     {
         Logger logger;
         Gpu gpu;
         Timer soundTimer;
         Timer delayTimer;
-        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
         chip8::Registers& registers(cpu.getRegisters());
         initTest(0xff, 0xff, cpu); // <unsupported instruction>
 
@@ -832,4 +913,280 @@ namespace chip8::unit_tests
             EXPECT_STREQ(e.what(), "invalid instruction");
         }
     }
-}
+
+    TEST_P(CpuUnitTests, self_modifying_code_executes_modified_instruction)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        initTest({0x71, 0x01,  // add v1, 1
+                  0xa2, 0x00,  // ld I, 0x200
+                  0x60, 0x72,  // ld v0, 0x72
+                  0xf0, 0x55,  // ld [I], v0 (turns "add v1, 1" into "add v2, 1")
+                  0x12, 0x00}, // jp 0x200
+                 cpu);
+
+        for (size_t i = 0; i < 6; i++)
+        {
+            cpu.runClockCycle();
+        }
+
+        EXPECT_EQ(*registers.PC, 0x202);
+        EXPECT_EQ(registers.V[1], 1);
+        EXPECT_EQ(registers.V[2], 1);
+    }
+
+    TEST_P(CpuUnitTests, run_executes_budget)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        initTest({0x70, 0x01,  // add v0, 1
+                  0x12, 0x00}, // jp 0x200
+                 cpu);
+
+        EXPECT_EQ(cpu.run(7).instructions, 7);
+        EXPECT_EQ(*registers.PC, 0x202);
+        EXPECT_EQ(registers.V[0], 4);
+    }
+
+    TEST_P(CpuUnitTests, run_reports_dirty_frame_after_draw)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        initTest({0x60, 0x05,  // ld v0, 5
+                  0xd0, 0x01,  // drw v0, v0, 1
+                  0x61, 0x01,  // ld v1, 1
+                  0x12, 0x04}, // jp 0x204
+                 cpu);
+
+        EXPECT_CALL(gpu, setSprite).Times(1);
+        const chip8::RunResult result = cpu.run(10);
+        EXPECT_EQ(result.instructions, 10);
+        EXPECT_EQ(result.stopReason, chip8::StopReason::BudgetExhausted);
+        EXPECT_TRUE(result.frameDirty);
+        EXPECT_EQ(registers.V[1], 1);
+
+        EXPECT_FALSE(cpu.run(10).frameDirty);
+    }
+
+    TEST_P(CpuUnitTests, run_stops_after_draw_in_display_wait_mode)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        cpu.setDisplayMode(chip8::DisplayMode::DisplayWait);
+        initTest({0x60, 0x05,  // ld v0, 5
+                  0xd0, 0x01,  // drw v0, v0, 1
+                  0x71, 0x01,  // add v1, 1
+                  0x12, 0x02}, // jp 0x202
+                 cpu);
+
+        EXPECT_CALL(gpu, setSprite).Times(2);
+        const chip8::RunResult drawn = cpu.run(10);
+        EXPECT_EQ(drawn.instructions, 2);
+        EXPECT_EQ(drawn.stopReason, chip8::StopReason::WaitForDraw);
+        EXPECT_TRUE(drawn.frameDirty);
+        EXPECT_EQ(registers.V[1], 0);
+
+        const chip8::RunResult nextFrame = cpu.run(10);
+        EXPECT_EQ(nextFrame.instructions, 3);
+        EXPECT_EQ(nextFrame.stopReason, chip8::StopReason::WaitForDraw);
+        EXPECT_EQ(registers.V[1], 1);
+    }
+
+    TEST_P(CpuUnitTests, run_stops_waiting_for_key)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        initTest({0x60, 0x05,  // ld v0, 5
+                  0xf1, 0x0a,  // ld v1, K
+                  0x70, 0x01}, // add v0, 1
+                 cpu);
+
+        const chip8::RunResult waiting = cpu.run(10);
+        EXPECT_EQ(waiting.instructions, 2);
+        EXPECT_EQ(waiting.stopReason, chip8::StopReason::WaitForKey);
+        EXPECT_EQ(*registers.PC, 0x202);
+
+        cpu.onKeyPressed(Key::Num3);
+        const chip8::RunResult resumed = cpu.run(2);
+        EXPECT_EQ(resumed.instructions, 2);
+        EXPECT_EQ(resumed.stopReason, chip8::StopReason::BudgetExhausted);
+        EXPECT_EQ(registers.V[0], 6);
+        EXPECT_EQ(registers.V[1], static_cast<uint8_t>(Key::Num3));
+    }
+
+    TEST_P(CpuUnitTests, run_reports_audio_change)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        initTest({0x60, 0x05,  // ld v0, 5
+                  0xf0, 0x18,  // ld ST, v0
+                  0x12, 0x04}, // jp 0x204
+                 cpu);
+
+        EXPECT_FALSE(cpu.run(2).audioChanged);
+        EXPECT_TRUE(cpu.run(2).audioChanged);
+        EXPECT_TRUE(cpu.shouldPlayAudio());
+        EXPECT_FALSE(cpu.run(2).audioChanged);
+    }
+
+    TEST_P(CpuUnitTests, run_self_modifying_code_executes_modified_instruction)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        initTest({0x71, 0x01,  // add v1, 1
+                  0xa2, 0x00,  // ld I, 0x200
+                  0x60, 0x72,  // ld v0, 0x72
+                  0xf0, 0x55,  // ld [I], v0 (turns "add v1, 1" into "add v2, 1")
+                  0x12, 0x00}, // jp 0x200
+                 cpu);
+
+        EXPECT_EQ(cpu.run(6).instructions, 6);
+        EXPECT_EQ(*registers.PC, 0x202);
+        EXPECT_EQ(registers.V[1], 1);
+        EXPECT_EQ(registers.V[2], 1);
+    }
+
+    TEST_P(CpuUnitTests, run_arithmetic_matches_interpreter)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu referenceCpu(logger, gpu, soundTimer, delayTimer, chip8::ExecutionEngine::Interpreter);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        const std::vector<uint8_t> program{0x60, 0x37,  // ld v0, 0x37
+                                           0x61, 0xc9,  // ld v1, 0xc9
+                                           0x6f, 0x80,  // ld vf, 0x80
+                                           0x80, 0x14,  // add v0, v1
+                                           0x81, 0x05,  // sub v1, v0
+                                           0x82, 0x17,  // subn v2, v1
+                                           0x83, 0x06,  // shr v3, v0
+                                           0x84, 0x0e,  // shl v4, v0
+                                           0x8f, 0x14,  // add vf, v1
+                                           0x85, 0xf5,  // sub v5, vf
+                                           0x8f, 0xf6,  // shr vf, vf
+                                           0x8f, 0x0e,  // shl vf, v0
+                                           0x86, 0x01,  // or v6, v0
+                                           0x87, 0x12,  // and v7, v1
+                                           0x88, 0x23,  // xor v8, v2
+                                           0x89, 0xf0,  // ld v9, vf
+                                           0x7a, 0x03,  // add va, 3
+                                           0xa3, 0x45,  // ld I, 0x345
+                                           0x3a, 0x30,  // se va, 0x30
+                                           0x12, 0x06,  // jp 0x206
+                                           0x5a, 0xb0,  // se va, vb
+                                           0x9a, 0xb0,  // sne va, vb
+                                           0x12, 0x00,  // jp 0x200
+                                           0x7b, 0x01,  // add vb, 1
+                                           0x12, 0x06}; // jp 0x206
+        initTest(program, referenceCpu);
+        initTest(program, cpu);
+
+        EXPECT_EQ(referenceCpu.run(1001).instructions, 1001);
+        EXPECT_EQ(cpu.run(1001).instructions, 1001);
+        EXPECT_EQ(cpu.getRegisters().V, referenceCpu.getRegisters().V);
+        EXPECT_EQ(*cpu.getRegisters().I, *referenceCpu.getRegisters().I);
+        EXPECT_EQ(*cpu.getRegisters().PC, *referenceCpu.getRegisters().PC);
+    }
+
+    TEST_P(CpuUnitTests, run_instruction_pairs_matches_interpreter)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu referenceCpu(logger, gpu, soundTimer, delayTimer, chip8::ExecutionEngine::Interpreter);
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        const std::vector<uint8_t> program{0x60, 0x00,  // ld v0, 0
+                                           0x61, 0x05,  // ld v1, 5
+                                           0xa3, 0x00,  // ld I, 0x300
+                                           0x62, 0x03,  // ld v2, 3
+                                           0x70, 0x01,  // add v0, 1
+                                           0x30, 0x02,  // se v0, 2
+                                           0x12, 0x08,  // jp 0x208
+                                           0x43, 0x00,  // sne v3, 0
+                                           0x12, 0x14,  // jp 0x214
+                                           0x00, 0x00,  // (unmatched)
+                                           0x81, 0x00,  // ld v1, v0
+                                           0x82, 0x10,  // ld v2, v1
+                                           0x60, 0x00,  // ld v0, 0
+                                           0x12, 0x08}; // jp 0x208
+        initTest(program, referenceCpu);
+        initTest(program, cpu);
+
+        // Budgets ending in the middle of pairs as well.
+        for (const size_t instructions : {1, 2, 3, 5, 7, 11, 13, 500})
+        {
+            EXPECT_EQ(referenceCpu.run(instructions).instructions, instructions);
+            EXPECT_EQ(cpu.run(instructions).instructions, instructions);
+            EXPECT_EQ(cpu.getRegisters().V, referenceCpu.getRegisters().V);
+            EXPECT_EQ(*cpu.getRegisters().I, *referenceCpu.getRegisters().I);
+            EXPECT_EQ(*cpu.getRegisters().PC, *referenceCpu.getRegisters().PC);
+        }
+    }
+
+    TEST_P(CpuUnitTests, compiled_rom_runs_translated_blocks)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        cpu.setCompiledRom(&compiled_rom::compiledRom);
+        initTest(compiled_rom::program, cpu);
+        compiled_rom::executedBlocks = 0;
+
+        EXPECT_EQ(cpu.run(6).instructions, 6);
+        EXPECT_EQ(compiled_rom::executedBlocks, 1); // The block is overwritten after its first execution
+        EXPECT_EQ(*registers.PC, 0x202);
+        EXPECT_EQ(registers.V[1], 1);
+        EXPECT_EQ(registers.V[2], 1);
+    }
+
+    TEST_P(CpuUnitTests, compiled_rom_is_ignored_for_other_roms)
+    {
+        Logger logger;
+        Gpu gpu;
+        Timer soundTimer;
+        Timer delayTimer;
+        chip8::Cpu cpu(logger, gpu, soundTimer, delayTimer, GetParam());
+        chip8::Registers& registers(cpu.getRegisters());
+        cpu.setCompiledRom(&compiled_rom::compiledRom);
+        initTest({0x71, 0x01,  // add v1, 1
+                  0x12, 0x00}, // jp 0x200
+                 cpu);
+        compiled_rom::executedBlocks = 0;
+
+        EXPECT_EQ(cpu.run(3).instructions, 3);
+        EXPECT_EQ(compiled_rom::executedBlocks, 0);
+        EXPECT_EQ(registers.V[1], 2);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <array>
+#include <emulator/FrameBufferExpansion.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace chip8::unit_tests
+{
+    class FrameBufferExpansionUnitTests : public ::testing::TestWithParam<chip8::SimdLevel>
+    {
+      protected:
+        void SetUp() override
+        {
+            if (GetParam() > chip8::getSimdLevel())
+            {
+                GTEST_SKIP() << "Not supported by this host";
+            }
+        }
+    };
+
+    TEST_P(FrameBufferExpansionUnitTests, ExpandFrameBuffer_Pattern_OnePixelPerBit)
+    {
+        const std::array<uint64_t, 3> frameBuffer{0x8000000000000001, 0xF0F0A5A5000FFFFE, 0};
+        const chip8::Palette palette{0xFF112233, 0xFF445566};
+        std::vector<uint32_t> pixels(64 * frameBuffer.size());
+
+        chip8::expandFrameBuffer(frameBuffer, palette, pixels.data(), 64 * sizeof(uint32_t), GetParam());
+
+        for (size_t y = 0; y < frameBuffer.size(); y++)
+        {
+            for (size_t x = 0; x < 64; x++)
+            {
+                const bool on = (frameBuffer[y] >> (63 - x)) & 1;
+                ASSERT_EQ(pixels[64 * y + x], on ? palette.foreground : palette.background) << "x=" << x << " y=" << y;
+            }
+        }
+    }
+
+    TEST_P(FrameBufferExpansionUnitTests, ExpandFrameBuffer_LargerPitch_LeavesPaddingUntouched)
+    {
+        const std::array<uint64_t, 2> frameBuffer{0xFFFFFFFFFFFFFFFF, 0};
+        const chip8::Palette palette;
+        constexpr size_t PixelsPerRow = 80;
+        std::vector<uint32_t> pixels(PixelsPerRow * frameBuffer.size(), 0x12345678);
+
+        chip8::expandFrameBuffer(frameBuffer, palette, pixels.data(), PixelsPerRow * sizeof(uint32_t), GetParam());
+
+        for (size_t x = 0; x < PixelsPerRow; x++)
+        {
+            ASSERT_EQ(pixels[x], x < 64 ? palette.foreground : 0x12345678);
+            ASSERT_EQ(pixels[PixelsPerRow + x], x < 64 ? palette.background : 0x12345678);
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels,
+                             FrameBufferExpansionUnitTests,
+                             ::testing::Values(chip8::SimdLevel::None, chip8::SimdLevel::Sse2, chip8::SimdLevel::Avx2));
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <emulator/FramePacer.hpp>
+#include <gtest/gtest.h>
+
+namespace chip8::unit_tests
+{
+    using namespace std::chrono_literals;
+
+    TEST(FramePacerUnitTests, GetFrameInstructions_RateNotMultipleOfFrameRate_ExactRatePerSecond)
+    {
+        chip8::FramePacer pacer(1000, chip8::OverrunPolicy::CatchUp);
+
+        uint64_t instructions = 0;
+        for (size_t frame = 0; frame < 3 * chip8::FramePacer::FrameRate; frame++)
+        {
+            const uint32_t frameInstructions = pacer.getFrameInstructions();
+            ASSERT_TRUE(frameInstructions == 16 || frameInstructions == 17);
+            instructions += frameInstructions;
+        }
+
+        ASSERT_EQ(instructions, 3000u);
+    }
+
+    TEST(FramePacerUnitTests, GetFrameInstructions_RateBelowFrameRate_SomeEmptyFrames)
+    {
+        chip8::FramePacer pacer(30, chip8::OverrunPolicy::CatchUp);
+
+        ASSERT_EQ(pacer.getFrameInstructions(), 0u);
+        ASSERT_EQ(pacer.getFrameInstructions(), 1u);
+        ASSERT_EQ(pacer.getFrameInstructions(), 0u);
+        ASSERT_EQ(pacer.getFrameInstructions(), 1u);
+    }
+
+    TEST(FramePacerUnitTests, OnFrameExecuted_OnTime_NextFrameOneFrameLater)
+    {
+        const auto start = chip8::FramePacer::Clock::time_point();
+        chip8::FramePacer pacer(600, chip8::OverrunPolicy::Drop, start);
+
+        ASSERT_EQ(pacer.onFrameExecuted(10, start + 1ms), start + chip8::FramePacer::FrameDuration);
+        ASSERT_EQ(pacer.onFrameExecuted(10, start + 20ms), start + 2 * chip8::FramePacer::FrameDuration);
+        ASSERT_EQ(pacer.getDroppedFrames(), 0u);
+    }
+
+    TEST(FramePacerUnitTests, OnFrameExecuted_LateCatchUp_NextFramesWithoutWaiting)
+    {
+        const auto start = chip8::FramePacer::Clock::time_point();
+        chip8::FramePacer pacer(600, chip8::OverrunPolicy::CatchUp, start);
+
+        const auto now = start + 5 * chip8::FramePacer::FrameDuration;
+        ASSERT_EQ(pacer.onFrameExecuted(10, now), start + chip8::FramePacer::FrameDuration);
+        ASSERT_EQ(pacer.onFrameExecuted(10, now), start + 2 * chip8::FramePacer::FrameDuration);
+        ASSERT_EQ(pacer.getDroppedFrames(), 0u);
+    }
+
+    TEST(FramePacerUnitTests, OnFrameExecuted_LateDrop_MissedFramesSkipped)
+    {
+        const auto start = chip8::FramePacer::Clock::time_point();
+        chip8::FramePacer pacer(600, chip8::OverrunPolicy::Drop, start);
+
+        const auto now = start + 5 * chip8::FramePacer::FrameDuration + 1ms;
+        ASSERT_EQ(pacer.onFrameExecuted(10, now), start + 5 * chip8::FramePacer::FrameDuration);
+        ASSERT_EQ(pacer.getDroppedFrames(), 4u);
+    }
+
+    TEST(FramePacerUnitTests, OnFrameExecuted_TooLateToCatchUp_MissedFramesSkipped)
+    {
+        const auto start = chip8::FramePacer::Clock::time_point();
+        chip8::FramePacer pacer(600, chip8::OverrunPolicy::CatchUp, start);
+
+        const auto now = start + (chip8::FramePacer::MaxCatchUpFrames + 10) * chip8::FramePacer::FrameDuration;
+        ASSERT_EQ(pacer.onFrameExecuted(10, now), now);
+        ASSERT_EQ(pacer.getDroppedFrames(), chip8::FramePacer::MaxCatchUpFrames + 9);
+    }
+
+    TEST(FramePacerUnitTests, GetAchievedRate_InstructionsExecuted_InstructionsPerSecond)
+    {
+        const auto start = chip8::FramePacer::Clock::time_point();
+        chip8::FramePacer pacer(600, chip8::OverrunPolicy::CatchUp, start);
+
+        pacer.onFrameExecuted(300, start + 100ms);
+        pacer.onFrameExecuted(200, start + 200ms);
+
+        ASSERT_DOUBLE_EQ(pacer.getAchievedRate(start + 1s), 500.0);
+        ASSERT_EQ(pacer.getRequestedRate(), 600u);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <cpu/FrameClock.hpp>
+#include <cpu/FrameTimer.hpp>
+#include <gtest/gtest.h>
+
+namespace chip8::unit_tests
+{
+    TEST(FrameTimerUnitTests, GetValue_FramesElapsed_DecrementedOncePerFrame)
+    {
+        chip8::FrameClock clock;
+        chip8::FrameTimer timer(clock);
+
+        timer.setValue(3);
+        timer.updateValue();
+        EXPECT_EQ(timer.getValue(), 3);
+
+        clock.tick();
+        EXPECT_EQ(timer.getValue(), 2);
+
+        clock.tick();
+        clock.tick();
+        EXPECT_EQ(timer.getValue(), 0);
+    }
+
+    TEST(FrameTimerUnitTests, GetValue_MoreFramesThanValue_StopsAtZero)
+    {
+        chip8::FrameClock clock;
+        chip8::FrameTimer timer(clock);
+
+        timer.setValue(2);
+        for (size_t i = 0; i < 300; i++)
+        {
+            clock.tick();
+        }
+
+        EXPECT_EQ(timer.getValue(), 0);
+    }
+
+    TEST(FrameTimerUnitTests, SetValue_AfterFramesElapsed_CountsFromNewValue)
+    {
+        chip8::FrameClock clock;
+        chip8::FrameTimer timer(clock);
+
+        timer.setValue(10);
+        clock.tick();
+        clock.tick();
+        timer.setValue(5);
+        EXPECT_EQ(timer.getValue(), 5);
+
+        clock.tick();
+        EXPECT_EQ(timer.getValue(), 4);
+    }
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cpu/Gpu.hpp>
 #include <functional>
 #include <gmock/gmock.h>
@@ -26,19 +27,37 @@ class Logger : public logging::Logger
 
 Logger loggerForGpu;
 
+namespace
+{
+    // Expands the framebuffer into one value per pixel, row after row.
+    std::vector<bool> getPixels(chip8::Gpu& gpu)
+    {
+        std::vector<bool> pixels;
+        for (const uint64_t row : gpu.getFrameBuffer())
+        {
+            for (size_t x = 0; x < gpu.getWidth(); x++)
+            {
+                pixels.push_back((row >> (gpu.getWidth() - 1 - x)) & 1);
+            }
+        }
+
+        return pixels;
+    }
+}
+
 namespace chip8::unit_tests
 {
     TEST(GpuUnitTests, Clear_DirtyFrameBuffer_ClearSuccessfully)
     {
         chip8::Gpu gpu(loggerForGpu);
 
-        std::vector<bool>& frameBuffer = const_cast<std::vector<bool>&>(gpu.getFrameBuffer());
-        frameBuffer[0] = true;
-        frameBuffer[5] = true;
+        gpu.setSprite(0, 0, std::vector<uint8_t>{0b10000100});
+        ASSERT_TRUE(getPixels(gpu)[0]);
+        ASSERT_TRUE(getPixels(gpu)[5]);
 
         gpu.clear();
 
-        for (const bool pixel : frameBuffer)
+        for (const bool pixel : getPixels(gpu))
         {
             ASSERT_FALSE(pixel);
         }
@@ -54,7 +73,7 @@ namespace chip8::unit_tests
 
         const bool pixelErased = gpu.setSprite(5, 6, sprite);
 
-        const std::vector<bool>& frameBuffer = gpu.getFrameBuffer();
+        const std::vector<bool> frameBuffer = getPixels(gpu);
         size_t lineStart = gpu.getWidth() * 6 + 5;
 
         ASSERT_TRUE(frameBuffer[lineStart]);
@@ -87,10 +106,10 @@ namespace chip8::unit_tests
         sprite.push_back(0b10010110);
         sprite.push_back(0b01101001);
 
-        std::vector<bool>& frameBuffer = const_cast<std::vector<bool>&>(gpu.getFrameBuffer());
-        frameBuffer[gpu.getWidth() * 6 + 5] = true;
+        ASSERT_FALSE(gpu.setSprite(5, 6, std::vector<uint8_t>{0b10000000}));
 
         const bool pixelErased = gpu.setSprite(5, 6, sprite);
+        const std::vector<bool> frameBuffer = getPixels(gpu);
 
         size_t lineStart = gpu.getWidth() * 6 + 5;
         ASSERT_FALSE(frameBuffer[lineStart]);
@@ -123,10 +142,10 @@ namespace chip8::unit_tests
         sprite.push_back(0b00010110);
         sprite.push_back(0b01101001);
 
-        std::vector<bool>& frameBuffer = const_cast<std::vector<bool>&>(gpu.getFrameBuffer());
-        frameBuffer[gpu.getWidth() * 6 + 5] = true;
+        ASSERT_FALSE(gpu.setSprite(5, 6, std::vector<uint8_t>{0b10000000}));
 
         const bool pixelErased = gpu.setSprite(5, 6, sprite);
+        const std::vector<bool> frameBuffer = getPixels(gpu);
 
         size_t lineStart = gpu.getWidth() * 6 + 5;
         ASSERT_TRUE(frameBuffer[lineStart]);
@@ -161,7 +180,7 @@ namespace chip8::unit_tests
 
         const bool pixelErased = gpu.setSprite(gpu.getWidth() - 1, 0, sprite);
 
-        const std::vector<bool>& frameBuffer = gpu.getFrameBuffer();
+        const std::vector<bool> frameBuffer = getPixels(gpu);
 
         size_t lineStart = gpu.getWidth() - 1;
 
@@ -186,4 +205,56 @@ namespace chip8::unit_tests
 
         ASSERT_FALSE(pixelErased);
     }
+
+    TEST(GpuUnitTests, SetSprite_BottomOfScreen_CutOutOfScreenRows)
+    {
+        chip8::Gpu gpu(loggerForGpu);
+
+        std::vector<uint8_t> sprite;
+        sprite.push_back(0b11000000);
+        sprite.push_back(0b00110000);
+
+        const bool pixelErased = gpu.setSprite(0, gpu.getHeight() - 1, sprite);
+
+        const std::vector<bool> frameBuffer = getPixels(gpu);
+        const size_t lineStart = gpu.getWidth() * (gpu.getHeight() - 1);
+
+        ASSERT_TRUE(frameBuffer[lineStart]);
+        ASSERT_TRUE(frameBuffer[lineStart + 1]);
+        ASSERT_EQ(std::count(frameBuffer.begin(), frameBuffer.end(), true), 2);
+
+        ASSERT_FALSE(pixelErased);
+    }
+
+    TEST(GpuUnitTests, GetDirtyRows_SpriteDrawn_RowsOfSpriteDirty)
+    {
+        chip8::Gpu gpu(loggerForGpu);
+
+        gpu.setSprite(3, 4, std::vector<uint8_t>{0b10000000, 0b00000000, 0b00000001});
+
+        ASSERT_EQ(gpu.getDirtyRows(), 0b10000u | 0b1000000u);
+    }
+
+    TEST(GpuUnitTests, GetDirtyRows_SpriteDrawnThenErased_NoDirtyRows)
+    {
+        chip8::Gpu gpu(loggerForGpu);
+
+        gpu.setSprite(3, 4, std::vector<uint8_t>{0b10010110});
+        gpu.setSprite(3, 4, std::vector<uint8_t>{0b10010110});
+
+        ASSERT_EQ(gpu.getDirtyRows(), 0u);
+    }
+
+    TEST(GpuUnitTests, GetDirtyRows_DrawComplete_ComparedToShownFrame)
+    {
+        chip8::Gpu gpu(loggerForGpu);
+
+        gpu.setSprite(0, 1, std::vector<uint8_t>{0b11000000});
+        gpu.setSprite(0, 2, std::vector<uint8_t>{0b11000000});
+        gpu.onDrawComplete();
+        ASSERT_EQ(gpu.getDirtyRows(), 0u);
+
+        gpu.clear();
+        ASSERT_EQ(gpu.getDirtyRows(), 0b110u);
+    }
 }
\ No newline at end of file
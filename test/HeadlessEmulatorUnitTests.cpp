@@ -0,0 +1,155 @@
+#include <array>
+#include <emulator/HeadlessEmulator.hpp>
+#include <emulator/InputScript.hpp>
+#include <emulator/InputScriptException.hpp>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    chip8::HeadlessEmulator::Report runRom(const std::string& rom,
+                                           const std::string& script,
+                                           const uint64_t maxFrames,
+                                           const uint64_t maxInstructions,
+                                           const uint64_t seed = 1)
+    {
+        SilentLogger logger;
+        chip8::HeadlessEmulator emulator(logger, chip8::ExecutionEngine::Interpreter, chip8::DisplayMode::Coalesced);
+        std::istringstream romData(rom);
+        emulator.boot(romData, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, seed));
+
+        std::istringstream scriptData(script);
+        return emulator.run(chip8::InputScript(scriptData), 600, maxFrames, maxInstructions, false);
+    }
+
+    // ld v0, k; ld f, v0; drw v1, v1, 5; jp 0x206
+    const std::string DrawPressedKey("\xF0\x0A\xF0\x29\xD1\x15\x12\x06", 8);
+    // rnd v0, 0xf; ld f, v0; cls; drw v1, v1, 5; jp 0x200
+    const std::string DrawRandomDigits("\xC0\x0F\xF0\x29\x00\xE0\xD1\x15\x12\x00", 10);
+    // jp 0x200
+    const std::string Loop("\x12\x00", 2);
+}
+
+namespace chip8::unit_tests
+{
+    TEST(HeadlessEmulatorUnitTests, InputScript_EventsOutOfOrder_SortedByFrame)
+    {
+        std::istringstream script("# frame key action\n"
+                                  "10 a up\n"
+                                  "\n"
+                                  "2 A down\n"
+                                  "2 3 down\n");
+        const chip8::InputScript input(script);
+        const auto& events = input.getEvents();
+
+        ASSERT_EQ(events.size(), 3u);
+        ASSERT_EQ(events[0].frame, 2u);
+        ASSERT_EQ(events[0].key, chip8::Key::DigitA);
+        ASSERT_TRUE(events[0].pressed);
+        ASSERT_EQ(events[1].key, chip8::Key::Num3);
+        ASSERT_EQ(events[2].frame, 10u);
+        ASSERT_FALSE(events[2].pressed);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, InputScript_MalformedLine_Throws)
+    {
+        for (const char* line : {"1 5", "1 G down", "1 5 pressed", "x 5 down", "1 5 down now", "-1 5 down"})
+        {
+            std::istringstream script(line);
+            ASSERT_THROW(chip8::InputScript input(script), chip8::InputScriptException) << line;
+        }
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Run_FrameLimit_ClockInstructionsPerFrame)
+    {
+        const chip8::HeadlessEmulator::Report report = runRom(Loop, "", 120, 0);
+
+        ASSERT_EQ(report.frames, 120u);
+        ASSERT_EQ(report.instructions, 1200u);
+        ASSERT_EQ(report.drawnFrames, 0u);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Run_InstructionLimit_StopsWithinFrame)
+    {
+        const chip8::HeadlessEmulator::Report report = runRom(Loop, "", 0, 25);
+
+        ASSERT_EQ(report.frames, 3u);
+        ASSERT_EQ(report.instructions, 25u);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Run_WaitingForKeyWithoutInput_StopsEarly)
+    {
+        const chip8::HeadlessEmulator::Report report = runRom(DrawPressedKey, "", 0, 1000);
+
+        ASSERT_TRUE(report.waitingForKey);
+        ASSERT_EQ(report.instructions, 1u);
+        ASSERT_EQ(report.frameBufferHash, chip8::HeadlessEmulator::hashFrameBuffer(std::array<uint64_t, chip8::Gpu::Height>{}));
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Run_KeyPressedByScript_ProgramResumes)
+    {
+        const chip8::HeadlessEmulator::Report report5 = runRom(DrawPressedKey, "3 5 down\n5 5 up\n", 10, 0);
+        const chip8::HeadlessEmulator::Report report6 = runRom(DrawPressedKey, "3 6 down\n5 6 up\n", 10, 0);
+
+        ASSERT_FALSE(report5.waitingForKey);
+        ASSERT_EQ(report5.drawnFrames, 1u);
+        ASSERT_NE(report5.frameBufferHash, chip8::HeadlessEmulator::hashFrameBuffer(std::array<uint64_t, chip8::Gpu::Height>{}));
+        ASSERT_NE(report5.frameBufferHash, report6.frameBufferHash);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Run_SameSeed_SameFrameBuffer)
+    {
+        const chip8::HeadlessEmulator::Report report1 = runRom(DrawRandomDigits, "", 7, 0, 41);
+        const chip8::HeadlessEmulator::Report report2 = runRom(DrawRandomDigits, "", 7, 0, 41);
+        const chip8::HeadlessEmulator::Report report3 = runRom(DrawRandomDigits, "", 7, 0, 42);
+
+        ASSERT_EQ(report1.frameBufferHash, report2.frameBufferHash);
+        ASSERT_NE(report1.frameBufferHash, report3.frameBufferHash);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, Boot_AfterAnotherRun_SameAsNewInstance)
+    {
+        SilentLogger logger;
+        chip8::HeadlessEmulator emulator(logger, chip8::ExecutionEngine::Interpreter, chip8::DisplayMode::Coalesced);
+        std::istringstream noInput("");
+        const chip8::InputScript input(noInput);
+
+        std::istringstream otherRom(DrawPressedKey);
+        std::istringstream keyDown("0 5 down\n");
+        emulator.boot(otherRom, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, 1));
+        emulator.run(chip8::InputScript(keyDown), 600, 10, 0, false);
+
+        std::istringstream rom(DrawRandomDigits);
+        emulator.boot(rom, chip8::RandomGenerator(chip8::RandomEngine::Xorshift, 41));
+        const chip8::HeadlessEmulator::Report report = emulator.run(input, 600, 7, 0, false);
+
+        ASSERT_EQ(report.frameBufferHash, runRom(DrawRandomDigits, "", 7, 0, 41).frameBufferHash);
+        ASSERT_EQ(report.drawnFrames, runRom(DrawRandomDigits, "", 7, 0, 41).drawnFrames);
+    }
+
+    TEST(HeadlessEmulatorUnitTests, HashFrameBuffer_PixelsInDifferentRows_DifferentHashes)
+    {
+        std::array<uint64_t, chip8::Gpu::Height> frameBuffer1{};
+        std::array<uint64_t, chip8::Gpu::Height> frameBuffer2{};
+        frameBuffer1[0] = 1;
+        frameBuffer2[1] = 1;
+
+        ASSERT_NE(chip8::HeadlessEmulator::hashFrameBuffer(frameBuffer1), chip8::HeadlessEmulator::hashFrameBuffer(frameBuffer2));
+    }
+}
\ No newline at end of file
@@ -131,4 +131,26 @@ namespace chip8::unit_tests
                                                         { binderHandler.handler4(v, vv, vvv, vvvv); });
         binder.match(v1 << 4 | v2, v3 << 4 | v4);
     }
+
+    TEST(InstructionBinderUnitTests, InstructionBinder_MaskAndValue_MatchPattern)
+    {
+        constexpr binding::MatchingPatternType u1 = 0xf, u2 = chip8::binding::placeholder, u3 = 0x6, u4 = 0x5;
+
+        using Binder = chip8::InstructionBinder<u1, u2, u3, u4>;
+        static_assert(Binder::Mask == 0xF0FF);
+        static_assert(Binder::Value == 0xF065);
+        EXPECT_TRUE(Binder::matches(0xfa, 0x65));
+        EXPECT_FALSE(Binder::matches(0xfa, 0x55));
+    }
+
+    TEST(InstructionBinderUnitTests, InstructionBinder_Bind_InvokesCallbackWithoutMatching)
+    {
+        constexpr binding::MatchingPatternType u1 = 1, u2 = chip8::binding::placeholder, u3 = 3, u4 = 4;
+        constexpr binding::MatchingPatternType v2 = 0xa;
+
+        BinderHandler binderHandler;
+        EXPECT_CALL(binderHandler, handler1(v2)).Times(1);
+        chip8::InstructionBinder<u1, u2, u3, u4> binder([&](const binding::MatchingPatternType v) { binderHandler.handler1(v); });
+        binder.bind((u1 + 1) << 4 | v2, u3 << 4 | u4);
+    }
 }
\ No newline at end of file
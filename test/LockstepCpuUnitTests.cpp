@@ -0,0 +1,235 @@
+#include <cpu/LockstepCpu.hpp>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    // More lanes than an AVX2 vector holds, and not a multiple of it.
+    constexpr size_t Lanes = 45;
+
+    // ld v0, 5; skp v0; ld v1, 7; ld v2, 9; jp 0x208
+    const std::string SkipOnKey("\x60\x05\xE0\x9E\x61\x07\x62\x09\x12\x08", 10);
+    // ld v0, k; ld i, 0x300; ld b, v0; jp 0x206
+    const std::string StorePressedKey("\xF0\x0A\xA3\x00\xF0\x33\x12\x06", 8);
+    // ld v0, k; ld i, 0x20b; ld [i], v0; jp 0x20a; (0x208) 0000; (0x20a) ld v1, 0; jp 0x20c
+    const std::string PatchCode("\xF0\x0A\xA2\x0B\xF0\x55\x12\x0A\x00\x00\x61\x00\x12\x0C", 14);
+    // ld v0, k; se v0, 5; sys 0; jp 0x206
+    const std::string FailUnlessKey5("\xF0\x0A\x30\x05\x00\x00\x12\x06", 8);
+    // ld v0, 5; ld dt, v0; ld st, v0; jp 0x206
+    const std::string SetTimers("\x60\x05\xF0\x15\xF0\x18\x12\x06", 8);
+    // ld v0, 0xf0; ld v1, 0x20; add v0, v1; sub v1, v0; shl v0, v0; shr v1, v1; jp 0x20c
+    const std::string Arithmetic("\x60\xF0\x61\x20\x80\x14\x81\x05\x80\x0E\x81\x16\x12\x0C", 14);
+
+    std::vector<uint64_t> getSeeds(const size_t lanes)
+    {
+        std::vector<uint64_t> seeds(lanes);
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            seeds[lane] = lane;
+        }
+        return seeds;
+    }
+}
+
+namespace chip8::unit_tests
+{
+    class LockstepCpuUnitTests : public ::testing::TestWithParam<chip8::SimdLevel>
+    {
+      protected:
+        void SetUp() override
+        {
+            if (GetParam() > chip8::getSimdLevel())
+            {
+                GTEST_SKIP() << "Not supported by this host";
+            }
+        }
+
+        void boot(const std::string& rom)
+        {
+            std::istringstream romData(rom);
+            cpu.boot(romData, getSeeds(Lanes));
+        }
+
+        SilentLogger logger;
+        chip8::LockstepCpu cpu{logger, Lanes, GetParam()};
+    };
+
+    TEST_P(LockstepCpuUnitTests, Run_DivergingLanes_EachTakesItsBranch)
+    {
+        boot(SkipOnKey);
+        for (size_t lane = 0; lane < Lanes; lane += 2)
+        {
+            cpu.onKeyPressed(lane, chip8::Key::Num5);
+        }
+
+        EXPECT_EQ(cpu.run(4), 4 * Lanes);
+
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            EXPECT_EQ(cpu.getV(lane, 1), lane % 2 == 0 ? 0 : 7) << lane;
+            EXPECT_EQ(cpu.getV(lane, 2), 9) << lane;
+            EXPECT_EQ(cpu.getPC(lane), 0x208) << lane;
+        }
+    }
+
+    TEST_P(LockstepCpuUnitTests, Run_Arithmetic_SetsFlagsAsCpu)
+    {
+        boot(Arithmetic);
+
+        cpu.run(3);
+        EXPECT_EQ(cpu.getV(Lanes - 1, 0), 0x10);
+        EXPECT_EQ(cpu.getV(Lanes - 1, 0xF), 1); // Carry
+
+        cpu.run(1);
+        EXPECT_EQ(cpu.getV(Lanes - 1, 1), 0x10);
+        EXPECT_EQ(cpu.getV(Lanes - 1, 0xF), 1); // No borrow
+
+        cpu.run(2);
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            EXPECT_EQ(cpu.getV(lane, 0), 0x20) << lane;
+            EXPECT_EQ(cpu.getV(lane, 1), 0x08) << lane;
+            EXPECT_EQ(cpu.getV(lane, 0xF), 0) << lane;
+        }
+    }
+
+    TEST_P(LockstepCpuUnitTests, Run_Writes_CopyOnlyTheWrittenPages)
+    {
+        boot(StorePressedKey);
+        for (size_t lane = 0; lane < Lanes; lane += 2)
+        {
+            cpu.onKeyPressed(lane, static_cast<chip8::Key>(lane % 16));
+        }
+
+        cpu.run(10);
+
+        EXPECT_EQ(cpu.getPrivatePageCount(), (Lanes + 1) / 2);
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            EXPECT_EQ(cpu.isWaitingForKey(lane), lane % 2 == 1) << lane;
+            EXPECT_EQ(cpu.readMemory(lane, 0x301), lane % 2 == 0 ? lane % 16 / 10 : 0) << lane;
+            EXPECT_EQ(cpu.readMemory(lane, 0x302), lane % 2 == 0 ? lane % 16 % 10 : 0) << lane;
+            EXPECT_EQ(cpu.readMemory(lane, 0x200), 0xF0) << lane;
+        }
+    }
+
+    TEST_P(LockstepCpuUnitTests, Run_LanesPatchingTheirCode_ExecuteTheirOwnInstructions)
+    {
+        boot(PatchCode);
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            cpu.onKeyPressed(lane, static_cast<chip8::Key>(lane % 16));
+        }
+
+        EXPECT_EQ(cpu.run(6), 6 * Lanes);
+
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            EXPECT_EQ(cpu.getV(lane, 1), lane % 16) << lane;
+            EXPECT_EQ(cpu.getPC(lane), 0x20C) << lane;
+        }
+    }
+
+    TEST_P(LockstepCpuUnitTests, Run_ErrorOnALane_StopsOnlyThatLane)
+    {
+        boot(FailUnlessKey5);
+        cpu.onKeyPressed(3, chip8::Key::Num5);
+        cpu.onKeyPressed(4, chip8::Key::Num6);
+
+        cpu.run(10);
+
+        EXPECT_FALSE(cpu.getError(3).has_value());
+        EXPECT_EQ(cpu.getPC(3), 0x206);
+        EXPECT_EQ(cpu.getError(4), chip8::CpuErrorCode::UnsupportedSysInstruction);
+        EXPECT_TRUE(cpu.isWaitingForKey(5));
+
+        // Stopped lanes no longer run, waiting ones try again.
+        cpu.onKeyPressed(4, chip8::Key::Num5);
+        cpu.onKeyPressed(5, chip8::Key::Num5);
+        cpu.run(10);
+
+        EXPECT_EQ(cpu.getError(4), chip8::CpuErrorCode::UnsupportedSysInstruction);
+        EXPECT_FALSE(cpu.getError(5).has_value());
+        EXPECT_EQ(cpu.getPC(5), 0x206);
+    }
+
+    TEST_P(LockstepCpuUnitTests, TickTimers_AfterSet_CountDownToZero)
+    {
+        boot(SetTimers);
+        cpu.run(3);
+
+        for (size_t tick = 0; tick < 7; tick++)
+        {
+            EXPECT_EQ(cpu.shouldPlayAudio(0), tick < 5);
+            cpu.tickTimers();
+        }
+
+        EXPECT_EQ(cpu.getDelayTimer(Lanes - 1), 0);
+        EXPECT_EQ(cpu.getSoundTimer(Lanes - 1), 0);
+    }
+
+    TEST_P(LockstepCpuUnitTests, Boot_AfterRun_ResetsEveryLane)
+    {
+        boot(StorePressedKey);
+        cpu.onKeyPressed(0, chip8::Key::Num7);
+        cpu.run(10);
+
+        boot(StorePressedKey);
+
+        EXPECT_EQ(cpu.getPrivatePageCount(), 0);
+        EXPECT_EQ(cpu.readMemory(0, 0x302), 0);
+        EXPECT_EQ(cpu.getPC(0), 0x200);
+        EXPECT_EQ(cpu.getV(0, 0), 0);
+        EXPECT_EQ(cpu.run(10), Lanes);
+    }
+
+    TEST_P(LockstepCpuUnitTests, Restore_StateOfAnotherLane_ContinuesFromIt)
+    {
+        boot(StorePressedKey);
+        const chip8::LockstepCpu::LaneState bootState = cpu.save(1);
+        cpu.onKeyPressed(0, chip8::Key::Num7);
+        cpu.run(10);
+
+        cpu.restore(1, cpu.save(0), 1);
+        cpu.restore(0, bootState, 0);
+
+        EXPECT_EQ(cpu.getPrivatePageCount(), 1);
+        EXPECT_EQ(cpu.readMemory(1, 0x302), 7);
+        EXPECT_EQ(cpu.getPC(1), 0x206);
+        EXPECT_EQ(cpu.readMemory(0, 0x302), 0);
+        EXPECT_EQ(cpu.getPC(0), 0x200);
+
+        cpu.onKeyPressed(0, chip8::Key::Num8);
+        cpu.run(10);
+        EXPECT_EQ(cpu.readMemory(0, 0x302), 8);
+        EXPECT_EQ(cpu.getPrivatePageCount(), 2);
+    }
+
+    TEST_P(LockstepCpuUnitTests, Boot_SeedCountDifferentFromLanes_Throws)
+    {
+        std::istringstream romData(SetTimers);
+        const std::vector<uint64_t> seeds(Lanes - 1);
+
+        EXPECT_THROW(cpu.boot(romData, seeds), std::invalid_argument);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, LockstepCpuUnitTests, ::testing::Values(chip8::SimdLevel::None, chip8::SimdLevel::Avx2));
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <array>
+#include <cpu/RandomGenerator.hpp>
+#include <gtest/gtest.h>
+
+namespace chip8::unit_tests
+{
+    class RandomGeneratorUnitTests : public ::testing::TestWithParam<chip8::RandomEngine>
+    {
+    };
+
+    TEST_P(RandomGeneratorUnitTests, Next_SameSeed_SameNumbers)
+    {
+        chip8::RandomGenerator generator1(GetParam(), 1234);
+        chip8::RandomGenerator generator2(GetParam(), 1234);
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(generator1.next(), generator2.next());
+        }
+    }
+
+    TEST_P(RandomGeneratorUnitTests, Next_DifferentSeeds_DifferentNumbers)
+    {
+        chip8::RandomGenerator generator1(GetParam(), 1);
+        chip8::RandomGenerator generator2(GetParam(), 2);
+
+        size_t differences = 0;
+        for (size_t i = 0; i < 1000; i++)
+        {
+            differences += generator1.next() != generator2.next();
+        }
+
+        EXPECT_GT(differences, 900);
+    }
+
+    TEST_P(RandomGeneratorUnitTests, Next_ManyNumbers_GeneratesAllBytes)
+    {
+        chip8::RandomGenerator generator(GetParam());
+        std::array<bool, 256> generated{};
+
+        for (size_t i = 0; i < 256 * 64; i++)
+        {
+            generated[generator.next()] = true;
+        }
+
+        for (size_t value = 0; value < generated.size(); value++)
+        {
+            EXPECT_TRUE(generated[value]) << value;
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(RandomEngines,
+                             RandomGeneratorUnitTests,
+                             ::testing::Values(chip8::RandomEngine::Xorshift, chip8::RandomEngine::Standard));
+}
\ No newline at end of file
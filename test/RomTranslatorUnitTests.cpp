@@ -0,0 +1,58 @@
+#include <aot/RomTranslator.hpp>
+#include <cpu/RomLoadFailureException.hpp>
+#include <gtest/gtest.h>
+
+namespace chip8::unit_tests
+{
+    TEST(RomTranslatorUnitTests, Translate_Loop_BlocksStartAtBranchTargets)
+    {
+        chip8::aot::RomTranslator translator({0x60, 0x01,   // ld v0, 1
+                                              0x70, 0x01,   // add v0, 1
+                                              0x12, 0x02}); // jp 0x202
+
+        const std::map<uint16_t, size_t> expectedBlocks{{0x200, 3}, {0x202, 2}};
+        EXPECT_EQ(translator.getBlocks(), expectedBlocks);
+
+        const std::string source = translator.translate("loop");
+        EXPECT_NE(source.find("case 0x200:"), std::string::npos);
+        EXPECT_NE(source.find("goto block_202;"), std::string::npos);
+    }
+
+    TEST(RomTranslatorUnitTests, Translate_UnsupportedInstruction_SplitsBlocks)
+    {
+        chip8::aot::RomTranslator translator({0x60, 0x01,   // ld v0, 1
+                                              0xd0, 0x01,   // drw v0, v0, 1
+                                              0x70, 0x01,   // add v0, 1
+                                              0x12, 0x00}); // jp 0x200
+
+        const std::map<uint16_t, size_t> expectedBlocks{{0x200, 1}, {0x204, 2}};
+        EXPECT_EQ(translator.getBlocks(), expectedBlocks);
+    }
+
+    TEST(RomTranslatorUnitTests, Translate_ComputedJump_TargetNotTranslated)
+    {
+        chip8::aot::RomTranslator translator({0x60, 0x02,   // ld v0, 2
+                                              0xb2, 0x04,   // jp v0, 0x204
+                                              0x70, 0x01,   // add v0, 1
+                                              0x12, 0x06}); // jp 0x206
+
+        const std::map<uint16_t, size_t> expectedBlocks{{0x200, 1}};
+        EXPECT_EQ(translator.getBlocks(), expectedBlocks);
+    }
+
+    TEST(RomTranslatorUnitTests, Translate_DelayTimerLoop_SingleBlock)
+    {
+        chip8::aot::RomTranslator translator({0xf0, 0x07,   // ld v0, dt
+                                              0x30, 0x00,   // se v0, 0
+                                              0x12, 0x00}); // jp 0x200
+
+        const std::map<uint16_t, size_t> expectedBlocks{{0x200, 2}, {0x204, 1}};
+        EXPECT_EQ(translator.getBlocks(), expectedBlocks);
+        EXPECT_NE(translator.translate("wait").find("V[0x0] = state.delayTimer;"), std::string::npos);
+    }
+
+    TEST(RomTranslatorUnitTests, Constructor_RomTooLarge_Throws)
+    {
+        EXPECT_THROW(chip8::aot::RomTranslator(std::vector<uint8_t>(4 * 1024 - 0x200 + 1)), chip8::RomLoadFailureException);
+    }
+}
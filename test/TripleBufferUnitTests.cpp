@@ -0,0 +1,65 @@
+#include <emulator/TripleBuffer.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace chip8::unit_tests
+{
+    TEST(TripleBufferUnitTests, Read_NothingPublished_Nullptr)
+    {
+        chip8::TripleBuffer<int> buffer;
+
+        ASSERT_EQ(buffer.read(), nullptr);
+    }
+
+    TEST(TripleBufferUnitTests, Read_Published_LatestValueOnce)
+    {
+        chip8::TripleBuffer<int> buffer;
+
+        buffer.getWriteBuffer() = 1;
+        buffer.publish();
+        buffer.getWriteBuffer() = 2;
+        buffer.publish();
+
+        const int* value = buffer.read();
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, 2);
+        ASSERT_EQ(buffer.read(), nullptr);
+
+        buffer.getWriteBuffer() = 3;
+        buffer.publish();
+        ASSERT_EQ(*buffer.read(), 3);
+    }
+
+    TEST(TripleBufferUnitTests, Read_ConcurrentWriter_ValuesIncreaseAndAreWhole)
+    {
+        struct Value
+        {
+            int first;
+            int second;
+        };
+
+        constexpr int Values = 100000;
+        chip8::TripleBuffer<Value> buffer;
+
+        std::thread writer([&buffer]() {
+            for (int i = 1; i <= Values; i++)
+            {
+                buffer.getWriteBuffer() = {i, -i};
+                buffer.publish();
+            }
+        });
+
+        int last = 0;
+        while (last < Values)
+        {
+            if (const Value* value = buffer.read())
+            {
+                ASSERT_EQ(value->second, -value->first);
+                ASSERT_GT(value->first, last);
+                last = value->first;
+            }
+        }
+
+        writer.join();
+    }
+}
\ No newline at end of file
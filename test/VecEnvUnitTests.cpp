@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cpu/Gpu.hpp>
+#include <env/VecEnv.hpp>
+#include <gtest/gtest.h>
+#include <logging/Logger.hpp>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    class SilentLogger : public logging::Logger
+    {
+      public:
+        SilentLogger()
+            : logging::Logger(logging::Severity::Error)
+        {
+        }
+
+      protected:
+        void logInternal(const logging::Severity severity, const char* format, ...) const override
+        {
+        }
+    };
+
+    constexpr size_t Instances = 40;
+
+    // ld v0, k; ld f, v0; drw v1, v1, 5; jp 0x206
+    const std::string DrawPressedKey("\xF0\x0A\xF0\x29\xD1\x15\x12\x06", 8);
+    // add v1, 1; jp 0x200
+    const std::string Count("\x71\x01\x12\x00", 4);
+    // ld v0, k; sys 0
+    const std::string FailOnKey("\xF0\x0A\x00\x00", 4);
+
+    // One counted instruction per frame.
+    chip8::env::VecEnvOptions getCountOptions()
+    {
+        chip8::env::VecEnvOptions options;
+        options.instructionsPerFrame = 2;
+        options.framesPerStep = 1;
+        options.watched = {{chip8::env::Location::Kind::Register, 1}};
+        options.reward = [](std::span<const uint8_t> current, std::span<const uint8_t> previous) {
+            return static_cast<float>(current[0] - previous[0]);
+        };
+        return options;
+    }
+}
+
+namespace chip8::unit_tests
+{
+    class VecEnvUnitTests : public ::testing::Test
+    {
+      protected:
+        std::unique_ptr<chip8::env::VecEnv> createEnv(const std::string& rom, const chip8::env::VecEnvOptions& options)
+        {
+            std::istringstream romData(rom);
+            return std::make_unique<chip8::env::VecEnv>(logger, romData, Instances, 1, options);
+        }
+
+        SilentLogger logger;
+    };
+
+    TEST_F(VecEnvUnitTests, Step_KeyPerInstance_ObservationsAreTheFrameBuffers)
+    {
+        const auto env = createEnv(DrawPressedKey, {});
+        std::vector<uint16_t> actions(Instances);
+        for (size_t instance = 0; instance < Instances; instance++)
+        {
+            actions[instance] = static_cast<uint16_t>(1 << (instance % 16));
+        }
+
+        const chip8::env::StepResult result = env->step(actions);
+
+        ASSERT_EQ(result.observations.size(), Instances * chip8::Gpu::Height);
+        EXPECT_EQ(result.observations.data(), env->getCpu().getFrameBuffers().data());
+        for (size_t instance = 0; instance < Instances; instance++)
+        {
+            const std::span<const uint64_t> observation = result.observations.subspan(instance * chip8::Gpu::Height, chip8::Gpu::Height);
+            const std::span<const uint64_t> sameKey = result.observations.subspan(instance % 16 * chip8::Gpu::Height, chip8::Gpu::Height);
+            const std::span<const uint64_t> otherKey = result.observations.subspan((instance + 1) % 16 * chip8::Gpu::Height, chip8::Gpu::Height);
+
+            EXPECT_NE(observation[0], 0) << instance;
+            EXPECT_TRUE(std::equal(observation.begin(), observation.end(), sameKey.begin())) << instance;
+            EXPECT_FALSE(std::equal(observation.begin(), observation.end(), otherKey.begin())) << instance;
+            EXPECT_EQ(result.done[instance], 0) << instance;
+        }
+    }
+
+    TEST_F(VecEnvUnitTests, Step_RewardHook_GetsWatchedRegisterBeforeAndAfter)
+    {
+        const auto env = createEnv(Count, getCountOptions());
+        const std::vector<uint16_t> actions(Instances);
+
+        for (size_t step = 0; step < 3; step++)
+        {
+            const chip8::env::StepResult result = env->step(actions);
+
+            EXPECT_EQ(result.rewards[0], 1.0f);
+            EXPECT_EQ(result.rewards[Instances - 1], 1.0f);
+            EXPECT_EQ(env->getCpu().getV(0, 1), step + 1);
+        }
+    }
+
+    TEST_F(VecEnvUnitTests, Step_AfterDone_ResetsTheInstance)
+    {
+        chip8::env::VecEnvOptions options = getCountOptions();
+        options.done = [](std::span<const uint8_t> current) { return current[0] == 2; };
+        const auto env = createEnv(Count, options);
+        const std::vector<uint16_t> actions(Instances);
+
+        env->step(actions);
+        EXPECT_EQ(env->step(actions).done[0], 1);
+        EXPECT_EQ(env->getCpu().getV(0, 1), 2);
+
+        const chip8::env::StepResult result = env->step(actions);
+        EXPECT_EQ(result.done[0], 0);
+        EXPECT_EQ(result.rewards[0], 1.0f);
+        EXPECT_EQ(env->getCpu().getV(0, 1), 1);
+    }
+
+    TEST_F(VecEnvUnitTests, Step_CpuError_EndsTheEpisode)
+    {
+        const auto env = createEnv(FailOnKey, {});
+        std::vector<uint16_t> actions(Instances);
+        actions[3] = 1;
+
+        const chip8::env::StepResult result = env->step(actions);
+
+        EXPECT_EQ(result.done[3], 1);
+        EXPECT_EQ(result.done[4], 0);
+        EXPECT_EQ(env->getCpu().getError(3), chip8::CpuErrorCode::UnsupportedSysInstruction);
+
+        actions[3] = 0;
+        env->step(actions);
+        EXPECT_FALSE(env->getCpu().getError(3).has_value());
+    }
+
+    TEST_F(VecEnvUnitTests, Reset_AfterStartFrames_RestartsFromTheirEnd)
+    {
+        chip8::env::VecEnvOptions options = getCountOptions();
+        options.startFrames = 5;
+        const auto env = createEnv(Count, options);
+        EXPECT_EQ(env->getCpu().getV(Instances - 1, 1), 5);
+
+        env->step(std::vector<uint16_t>(Instances));
+        const chip8::env::StepResult result = env->reset();
+
+        EXPECT_EQ(env->getCpu().getV(Instances - 1, 1), 5);
+        EXPECT_EQ(env->getCpu().getPC(Instances - 1), 0x200);
+        EXPECT_EQ(result.rewards[0], 0.0f);
+    }
+
+    TEST_F(VecEnvUnitTests, Constructor_WatchedLocationOutOfBounds_Throws)
+    {
+        for (const chip8::env::Location location : {chip8::env::Location{chip8::env::Location::Kind::Register, 16},
+                                                     chip8::env::Location{chip8::env::Location::Kind::Memory, 0x1000}})
+        {
+            chip8::env::VecEnvOptions options;
+            options.watched = {location};
+
+            EXPECT_THROW(createEnv(Count, options), std::invalid_argument) << location.index;
+        }
+    }
+
+    TEST_F(VecEnvUnitTests, Step_ActionCountDifferentFromInstances_Throws)
+    {
+        const auto env = createEnv(Count, {});
+
+        EXPECT_THROW(env->step(std::vector<uint16_t>(Instances + 1)), std::invalid_argument);
+    }
+}
\ No newline at end of file
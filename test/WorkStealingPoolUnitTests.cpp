@@ -0,0 +1,87 @@
+#include <atomic>
+#include <batch/WorkStealingPool.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace chip8::unit_tests
+{
+    TEST(WorkStealingPoolUnitTests, Run_MoreJobsThanThreads_EveryJobRunOnce)
+    {
+        chip8::batch::WorkStealingPool pool(4);
+        std::vector<std::atomic<int>> runs(1000);
+
+        pool.run(runs.size(), [&](const size_t job, const size_t worker) {
+            ASSERT_LT(worker, pool.getThreadCount());
+            runs[job]++;
+        });
+
+        for (const std::atomic<int>& jobRuns : runs)
+        {
+            ASSERT_EQ(jobRuns, 1);
+        }
+    }
+
+    TEST(WorkStealingPoolUnitTests, Run_FewerJobsThanThreads_EveryJobRunOnce)
+    {
+        chip8::batch::WorkStealingPool pool(8);
+        std::vector<std::atomic<int>> runs(3);
+
+        pool.run(runs.size(), [&](const size_t job, const size_t) { runs[job]++; });
+        pool.run(0, [&](const size_t job, const size_t) { runs[job]++; });
+
+        for (const std::atomic<int>& jobRuns : runs)
+        {
+            ASSERT_EQ(jobRuns, 1);
+        }
+    }
+
+    TEST(WorkStealingPoolUnitTests, Run_OneWorkerBlocked_OthersStealItsJobs)
+    {
+        chip8::batch::WorkStealingPool pool(2);
+        std::vector<size_t> workers(100);
+
+        // Job 0 is the first one of worker 0: it only ends once worker 1 has run all the other jobs, including those of worker 0. The other
+        // jobs wait for it to start, so that worker 1 cannot steal it first.
+        std::atomic<bool> started(false);
+        std::atomic<size_t> done(0);
+        pool.run(workers.size(), [&](const size_t job, const size_t worker) {
+            workers[job] = worker;
+            if (job == 0)
+            {
+                started = true;
+                while (done < workers.size() - 1)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else
+            {
+                while (!started)
+                {
+                    std::this_thread::yield();
+                }
+                done++;
+            }
+        });
+
+        ASSERT_EQ(workers[0], 0u);
+        ASSERT_EQ(workers[1], 1u);
+        ASSERT_EQ(workers[99], 1u);
+    }
+
+    TEST(WorkStealingPoolUnitTests, Run_TaskThrows_Rethrown)
+    {
+        chip8::batch::WorkStealingPool pool(3);
+
+        ASSERT_THROW(pool.run(50,
+                              [](const size_t job, const size_t) {
+                                  if (job == 10)
+                                  {
+                                      throw std::runtime_error("job failed");
+                                  }
+                              }),
+                     std::runtime_error);
+    }
+}
\ No newline at end of file